@@ -0,0 +1,47 @@
+#include "Benchmark.h"
+
+#ifdef USE_SENTIO_BENCHMARK
+
+namespace esphome {
+namespace sentio {
+
+static touchscreen::TouchPoint bench_point(uint8_t id, int16_t x, int16_t y) {
+  touchscreen::TouchPoint p{};
+  p.id = id;
+  p.x = x;
+  p.y = y;
+  return p;
+}
+
+bool BenchSource::load_frame(BenchWorkload workload, uint8_t frame) {
+  this->touches.clear();
+
+  switch (workload) {
+  case BENCH_TAP:
+    if (frame >= BENCH_TAP_FRAMES)
+      return false;
+    this->touches[0] = bench_point(0, 120, 120);
+    return true;
+
+  case BENCH_SWIPE:
+    if (frame >= BENCH_DRAG_FRAMES)
+      return false;
+    this->touches[0] = bench_point(0, 40 + 8 * frame, 120);
+    return true;
+
+  case BENCH_MULTI:
+    if (frame >= BENCH_DRAG_FRAMES)
+      return false;
+    this->touches[0] = bench_point(0, 60 + 4 * frame, 80 + 2 * frame);
+    this->touches[1] = bench_point(1, 220 - 4 * frame, 160 - 2 * frame);
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_BENCHMARK
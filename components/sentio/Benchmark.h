@@ -0,0 +1,34 @@
+#pragma once
+#include "esphome/core/defines.h"
+
+#ifdef USE_SENTIO_BENCHMARK
+#include "esphome/components/touchscreen/touchscreen.h"
+
+namespace esphome {
+namespace sentio {
+
+// Scripted input for benchmark firmware (tools/sentio_bench.py). Each
+// workload is a fixed finger path so runs are comparable across builds.
+enum BenchWorkload : uint8_t {
+  BENCH_TAP,   // One finger, still, lifted well inside the tap window
+  BENCH_SWIPE, // One finger, steady sideways drag past the threshold
+  BENCH_MULTI, // Two fingers converging (pinch), tracker and publish load
+  NUM_BENCH_WORKLOADS,
+};
+
+static const uint8_t BENCH_TAP_FRAMES = 4;
+static const uint8_t BENCH_DRAG_FRAMES = 12;
+static const uint32_t BENCH_FRAME_MS = 10; // ~100Hz source
+
+// Stands in for the configured source while the benchmark runs
+class BenchSource : public touchscreen::Touchscreen {
+public:
+  // Load frame `frame` of a workload into `touches`; false once it's over
+  // (touches left empty: the release frame)
+  bool load_frame(BenchWorkload workload, uint8_t frame);
+};
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_BENCHMARK
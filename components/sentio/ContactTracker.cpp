@@ -0,0 +1,160 @@
+#include "ContactTracker.h"
+#include "Placement.h"
+
+namespace esphome {
+namespace sentio {
+
+static const int32_t MATCH_GATE_PX = 80; // Farther than this is a new finger
+static const int32_t MATCH_GATE = MATCH_GATE_PX * MATCH_GATE_PX;
+static const uint32_t MAX_PREDICT_MS = 50;
+
+void ContactTracker::reset() {
+  for (auto &t : this->tracks_)
+    t.active = false;
+}
+
+void SENTIO_HOT ContactTracker::update(const touchscreen::TouchPoint *points,
+                                       uint8_t count, uint32_t now,
+                                       uint8_t *ids) {
+  if (count > MAX_CONTACTS)
+    count = MAX_CONTACTS;
+
+  // Active tracks, in slot order
+  uint8_t track_slot[MAX_CONTACTS];
+  uint8_t num_tracks = 0;
+  for (uint8_t s = 0; s < MAX_CONTACTS; s++) {
+    if (this->tracks_[s].active)
+      track_slot[num_tracks++] = s;
+  }
+
+  // Square cost matrix; padding rows/columns cost exactly the gate, so
+  // "unmatched" competes fairly with a far-away match
+  uint8_t size = std::max(num_tracks, count);
+  for (uint8_t r = 0; r < size; r++) {
+    for (uint8_t c = 0; c < size; c++) {
+      int32_t cost = MATCH_GATE;
+      if (r < num_tracks && c < count) {
+        const Track &t = this->tracks_[track_slot[r]];
+        float dt = std::min(now - t.t, MAX_PREDICT_MS);
+        int32_t dx = points[c].x - int32_t(t.x + t.vx * dt);
+        int32_t dy = points[c].y - int32_t(t.y + t.vy * dt);
+        cost = std::min(dx * dx + dy * dy, MATCH_GATE);
+      }
+      this->cost_[r + 1][c + 1] = cost;
+    }
+  }
+  if (size > 0)
+    this->solve_(size);
+
+  // Matched points keep their track's slot
+  bool kept[MAX_CONTACTS] = {};
+  bool matched[MAX_CONTACTS] = {};
+  bool reassigned = false;
+  for (uint8_t c = 0; c < count; c++) {
+    uint8_t r = this->match_[c + 1] - 1;
+    if (r >= num_tracks || this->cost_[r + 1][c + 1] >= MATCH_GATE)
+      continue;
+    uint8_t slot = track_slot[r];
+    if (this->tracks_[slot].source_id != points[c].id)
+      reassigned = true;
+    this->follow_(this->tracks_[slot], points[c], now);
+    kept[slot] = true;
+    matched[c] = true;
+    ids[c] = slot;
+  }
+
+  // Lifted fingers free their slots before new ones are handed out, so a
+  // frame where some lift and others land never runs out
+  for (uint8_t s = 0; s < MAX_CONTACTS; s++) {
+    if (!kept[s])
+      this->tracks_[s].active = false;
+  }
+
+  // New fingers: lowest free slot. At most count slots are taken, so there
+  // is always one.
+  uint8_t next = 0;
+  for (uint8_t c = 0; c < count; c++) {
+    if (matched[c])
+      continue;
+    while (this->tracks_[next].active)
+      next++;
+    this->tracks_[next] = Track{};
+    this->follow_(this->tracks_[next], points[c], now);
+    ids[c] = next;
+  }
+
+  if (reassigned)
+    this->reassignments_++;
+}
+
+void SENTIO_HOT ContactTracker::follow_(Track &t,
+                                        const touchscreen::TouchPoint &p,
+                                        uint32_t now) {
+  // Velocity: half-weight EMA so one noisy frame can't fling the prediction
+  uint32_t dt = now - t.t;
+  if (t.active && dt > 0) {
+    t.vx = (t.vx + float(p.x - t.x) / dt) / 2;
+    t.vy = (t.vy + float(p.y - t.y) / dt) / 2;
+  }
+  t.active = true;
+  t.source_id = p.id;
+  t.x = p.x;
+  t.y = p.y;
+  t.t = now;
+}
+
+void SENTIO_HOT ContactTracker::solve_(uint8_t n) {
+  // Hungarian method with potentials (rows = tracks, columns = points).
+  // O(n^3) on an n <= 10 matrix: at most ~1000 inner steps per frame.
+  int32_t u[MAX_CONTACTS + 1] = {}, v[MAX_CONTACTS + 1] = {};
+  uint8_t p[MAX_CONTACTS + 1] = {}, way[MAX_CONTACTS + 1] = {};
+
+  for (uint8_t i = 1; i <= n; i++) {
+    int32_t minv[MAX_CONTACTS + 1];
+    bool used[MAX_CONTACTS + 1] = {};
+    for (uint8_t j = 0; j <= n; j++)
+      minv[j] = INT32_MAX;
+
+    p[0] = i;
+    uint8_t j0 = 0;
+    do {
+      used[j0] = true;
+      uint8_t i0 = p[j0], j1 = 0;
+      int32_t delta = INT32_MAX;
+      for (uint8_t j = 1; j <= n; j++) {
+        if (used[j])
+          continue;
+        int32_t cur = this->cost_[i0][j] - u[i0] - v[j];
+        if (cur < minv[j]) {
+          minv[j] = cur;
+          way[j] = j0;
+        }
+        if (minv[j] < delta) {
+          delta = minv[j];
+          j1 = j;
+        }
+      }
+      for (uint8_t j = 0; j <= n; j++) {
+        if (used[j]) {
+          u[p[j]] += delta;
+          v[j] -= delta;
+        } else {
+          minv[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+
+    do {
+      uint8_t j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0 != 0);
+  }
+
+  for (uint8_t j = 1; j <= n; j++)
+    this->match_[j] = p[j];
+}
+
+} // namespace sentio
+} // namespace esphome
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+
+#include "esphome.h"
+#include "esphome/components/touchscreen/touchscreen.h"
+
+namespace esphome {
+namespace sentio {
+
+// Fixed number of output slots (matches the largest controllers we proxy)
+static const uint8_t MAX_CONTACTS = 10;
+
+// Assigns Sentio-stable contact IDs (0..MAX_CONTACTS-1) frame to frame,
+// ignoring the controller's own IDs, which some chips reuse or swap when
+// fingers get close. Tracks are matched to new points by minimum total
+// distance to their velocity-predicted positions (exact assignment).
+// Everything lives in fixed arrays: no allocation per frame.
+class ContactTracker {
+public:
+  // Writes the stable ID of points[i] to ids[i]. Tracks with no point this
+  // frame are dropped (finger lifted).
+  void update(const touchscreen::TouchPoint *points, uint8_t count,
+              uint32_t now, uint8_t *ids);
+  void reset();
+
+  uint32_t get_reassignments() const { return reassignments_; }
+
+protected:
+  struct Track {
+    bool active{false};
+    uint8_t source_id{0}; // Controller ID last seen (for swap statistics)
+    int16_t x{0}, y{0};
+    float vx{0}, vy{0}; // px/ms
+    uint32_t t{0};
+  };
+
+  void follow_(Track &t, const touchscreen::TouchPoint &p, uint32_t now);
+  void solve_(uint8_t size);
+
+  std::array<Track, MAX_CONTACTS> tracks_{};
+
+  // Assignment workspace: cost_[track][point], 1-based for the solver
+  int32_t cost_[MAX_CONTACTS + 1][MAX_CONTACTS + 1]{};
+  uint8_t match_[MAX_CONTACTS + 1]{}; // match_[point] = track (1-based)
+
+  uint32_t reassignments_{0}; // Frames where we overrode the controller
+};
+
+} // namespace sentio
+} // namespace esphome
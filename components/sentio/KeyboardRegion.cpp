@@ -0,0 +1,142 @@
+#include "KeyboardRegion.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace sentio {
+
+static const uint8_t KEY_OFFSETS_VERSION = 1;
+static const int LEARN_SHIFT = 3; // EMA weight 1/8 per accepted press
+
+// Grid cells covering `px` pixels
+static uint16_t grid_cells(int16_t px) {
+  return (px + (1 << KEYBOARD_CELL_SHIFT) - 1) >> KEYBOARD_CELL_SHIFT;
+}
+
+void KeyboardRegion::add_row(const std::vector<std::string> &keys) {
+  this->rows_.push_back(keys);
+
+  // Lay out every key again: rows share the height, keys share their row
+  this->keys_.clear();
+  int16_t row_h = this->height_ / int16_t(this->rows_.size());
+  for (size_t r = 0; r < this->rows_.size(); r++) {
+    const auto &row = this->rows_[r];
+    int16_t key_w = this->width_ / int16_t(row.size());
+    for (size_t c = 0; c < row.size(); c++) {
+      if (this->keys_.size() >= KEYBOARD_MAX_KEYS)
+        return;
+      Key k;
+      k.label = row[c];
+      k.cx = this->x_ + key_w * int16_t(c) + key_w / 2;
+      k.cy = this->y_ + row_h * int16_t(r) + row_h / 2;
+      k.half_w = key_w / 2;
+      k.half_h = row_h / 2;
+      this->keys_.push_back(k);
+    }
+  }
+
+  // Allocated once here, at config time (the size only depends on the
+  // rectangle); taps never allocate
+  uint16_t cols = grid_cells(this->width_);
+  uint16_t rows = grid_cells(this->height_);
+  if (this->grid_ == nullptr)
+    this->grid_ = place_buffer<uint8_t>(cols * rows, this->placement_);
+  if (this->grid_ == nullptr)
+    return; // Reported by log_placement(); every tap misses
+  this->grid_cols_ = cols;
+  this->grid_rows_ = rows;
+  std::fill(this->grid_, this->grid_ + cols * rows, KEYBOARD_NO_KEY);
+  this->rebuild_row_ = 0;
+}
+
+bool KeyboardRegion::rebuild_step() {
+  if (!this->needs_rebuild())
+    return true;
+
+  // Assign each cell of this row to the nearest aim point (centre + learned
+  // offset), measured in key-size units so wide keys aren't favoured
+  uint16_t gy = this->rebuild_row_++;
+  int32_t py = this->y_ + (gy << KEYBOARD_CELL_SHIFT) +
+               (1 << (KEYBOARD_CELL_SHIFT - 1));
+  for (uint16_t gx = 0; gx < this->grid_cols_; gx++) {
+    int32_t px = this->x_ + (gx << KEYBOARD_CELL_SHIFT) +
+                 (1 << (KEYBOARD_CELL_SHIFT - 1));
+    float best = 1e9f;
+    uint8_t best_key = KEYBOARD_NO_KEY;
+    for (size_t i = 0; i < this->keys_.size(); i++) {
+      const Key &k = this->keys_[i];
+      float ex = (px - k.cx - this->offsets_.dx[i] / 4.0f) / k.half_w;
+      float ey = (py - k.cy - this->offsets_.dy[i] / 4.0f) / k.half_h;
+      float d = ex * ex + ey * ey;
+      if (d < best) {
+        best = d;
+        best_key = i;
+      }
+    }
+    this->grid_[gy * this->grid_cols_ + gx] = best_key;
+  }
+  return !this->needs_rebuild();
+}
+
+bool KeyboardRegion::press(int16_t x, int16_t y) {
+  uint8_t index = this->resolve(x, y);
+  if (index == KEYBOARD_NO_KEY)
+    return false;
+
+  if (this->learning_)
+    this->learn_(index, x, y);
+  this->on_key_.trigger(this->keys_[index].label);
+  return true;
+}
+
+void KeyboardRegion::learn_(uint8_t index, int16_t x, int16_t y) {
+  const Key &k = this->keys_[index];
+  int8_t &dx = this->offsets_.dx[index];
+  int8_t &dy = this->offsets_.dy[index];
+
+  // Quarter-pixel EMA of where this key is really hit, bounded to half a key
+  int32_t ex = (x - k.cx) * 4 - dx;
+  int32_t ey = (y - k.cy) * 4 - dy;
+  int32_t nx = clamp<int32_t>(dx + ex / (1 << LEARN_SHIFT), -k.half_w * 4,
+                              k.half_w * 4);
+  int32_t ny = clamp<int32_t>(dy + ey / (1 << LEARN_SHIFT), -k.half_h * 4,
+                              k.half_h * 4);
+  nx = clamp<int32_t>(nx, INT8_MIN, INT8_MAX);
+  ny = clamp<int32_t>(ny, INT8_MIN, INT8_MAX);
+  if (nx == dx && ny == dy)
+    return;
+
+  dx = nx;
+  dy = ny;
+  this->offsets_changed_ = true;
+  this->rebuild_row_ = 0; // Re-shape the grid during the next idle slices
+}
+
+void KeyboardRegion::log_placement() const {
+  std::string what = "Keyboard " + this->name_ + " grid";
+  sentio::log_placement(what.c_str(), this->grid_,
+                        grid_cells(this->width_) * grid_cells(this->height_));
+}
+
+void KeyboardRegion::restore() {
+  this->pref_ = global_preferences->make_preference<KeyOffsets>(
+      fnv1_hash("sentio_keyboard_" + this->name_));
+
+  KeyOffsets saved{};
+  if (this->pref_.load(&saved) && saved.version == KEY_OFFSETS_VERSION) {
+    this->offsets_ = saved;
+    this->rebuild_row_ = 0;
+  }
+}
+
+void KeyboardRegion::save() {
+  // Called on sleep, not per press, to spare the flash
+  if (!this->offsets_changed_)
+    return;
+  this->offsets_.version = KEY_OFFSETS_VERSION;
+  this->pref_.save(&this->offsets_);
+  this->offsets_changed_ = false;
+}
+
+} // namespace sentio
+} // namespace esphome
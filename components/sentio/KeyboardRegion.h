@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "esphome.h"
+#include "esphome/core/automation.h"
+
+#include "Placement.h"
+
+namespace esphome {
+namespace sentio {
+
+static const uint8_t KEYBOARD_MAX_KEYS = 64;
+static const uint8_t KEYBOARD_NO_KEY = 0xFF;
+static const uint8_t KEYBOARD_CELL_SHIFT = 2; // 4x4px lookup cells
+
+// Learned per-key aim correction, in quarter pixels (persisted as-is)
+struct KeyOffsets {
+  uint8_t version;
+  int8_t dx[KEYBOARD_MAX_KEYS];
+  int8_t dy[KEYBOARD_MAX_KEYS];
+};
+
+// On-screen keyboard: rows of equal-width keys inside a rectangle.
+// A tap resolves through a precomputed cell grid (one lookup). The grid is
+// built from key centres shifted by where users actually press them, so
+// learning moves the key boundaries instead of adding work per tap.
+class KeyboardRegion {
+public:
+  KeyboardRegion(const std::string &name, int16_t x, int16_t y, int16_t w,
+                 int16_t h)
+      : name_(name), x_(x), y_(y), width_(w), height_(h) {}
+
+  // Before add_row(), which allocates the grid
+  void set_placement(BufferPlacement placement) { placement_ = placement; }
+  void add_row(const std::vector<std::string> &keys);
+  void set_learning(bool b) { learning_ = b; }
+  Trigger<std::string> *get_key_trigger() { return &on_key_; }
+
+  bool contains(int16_t x, int16_t y) const {
+    return x >= x_ && y >= y_ && x < x_ + width_ && y < y_ + height_;
+  }
+  // Key index under (x, y), or KEYBOARD_NO_KEY. Caller checks contains().
+  uint8_t resolve(int16_t x, int16_t y) const {
+    if (grid_ == nullptr)
+      return KEYBOARD_NO_KEY;
+    return grid_[((y - y_) >> KEYBOARD_CELL_SHIFT) * grid_cols_ +
+                 ((x - x_) >> KEYBOARD_CELL_SHIFT)];
+  }
+  // Resolve a tap, fire on_key and learn from it. False if no key was hit.
+  bool press(int16_t x, int16_t y);
+
+  // Incremental work for idle loop slices. Return true when nothing is left.
+  bool rebuild_step();
+  bool needs_rebuild() const { return rebuild_row_ < grid_rows_; }
+  void restore();
+  void save();
+  void log_placement() const;
+
+  const std::string &get_key(uint8_t index) const { return keys_[index].label; }
+
+protected:
+  struct Key {
+    std::string label;
+    int16_t cx, cy; // Nominal centre
+    int16_t half_w, half_h;
+  };
+
+  void learn_(uint8_t index, int16_t x, int16_t y);
+
+  std::string name_;
+  int16_t x_, y_, width_, height_;
+  std::vector<std::vector<std::string>> rows_;
+  std::vector<Key> keys_;
+
+  // Cell grid: key index per 4x4px cell, rebuilt one cell row per slice.
+  // One read per tap, so it can live in PSRAM.
+  BufferPlacement placement_{PLACEMENT_AUTO};
+  uint8_t *grid_{nullptr};
+  uint16_t grid_cols_{0}, grid_rows_{0};
+  uint16_t rebuild_row_{0};
+
+  bool learning_{true};
+  bool offsets_changed_{false};
+  KeyOffsets offsets_{};
+  ESPPreferenceObject pref_;
+
+  Trigger<std::string> on_key_;
+};
+
+} // namespace sentio
+} // namespace esphome
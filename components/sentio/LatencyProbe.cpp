@@ -0,0 +1,87 @@
+#include "LatencyProbe.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "VirtualClock.h"
+
+namespace esphome {
+namespace sentio {
+
+void LatencyProbe::send(uint32_t input_time) {
+  this->expire_(input_time);
+
+  // Every slot busy: the oldest echo is the least likely to still arrive
+  Pending *slot = &this->pending_[0];
+  for (auto &p : this->pending_) {
+    if (!p.active) {
+      slot = &p;
+      break;
+    }
+    if (input_time - p.t > input_time - slot->t)
+      slot = &p;
+  }
+  if (slot->active)
+    this->lost_++;
+
+  uint16_t seq = this->next_seq_++;
+  if (this->next_seq_ == 0)
+    this->next_seq_ = 1;
+  *slot = {seq, input_time, true};
+  this->sent_++;
+  this->on_probe_.trigger(seq);
+}
+
+void LatencyProbe::on_echo_(float value) {
+  uint32_t now = millis();
+  if (std::isnan(value))
+    return;
+  uint16_t seq = uint16_t(lroundf(value));
+
+  for (auto &p : this->pending_) {
+    if (!p.active || p.seq != seq)
+      continue;
+    p.active = false;
+    uint32_t rtt = now - p.t;
+    this->samples_[this->sample_head_] = rtt;
+    this->sample_head_ = (this->sample_head_ + 1) % PROBE_SAMPLES;
+    if (this->sample_count_ < PROBE_SAMPLES)
+      this->sample_count_++;
+    ESP_LOGD("Sentio", "Probe %u round trip: %ums", seq, rtt);
+    if (this->last_sensor_)
+      this->last_sensor_->publish_state(rtt);
+    return;
+  }
+  // Not ours (restart, late echo after a timeout, manual state change)
+}
+
+void LatencyProbe::expire_(uint32_t now) {
+  for (auto &p : this->pending_) {
+    if (p.active && now - p.t > this->timeout_ms_) {
+      p.active = false;
+      this->lost_++;
+      ESP_LOGW("Sentio", "Probe %u: no echo within %ums", p.seq,
+               this->timeout_ms_);
+    }
+  }
+}
+
+void LatencyProbe::publish() {
+  this->expire_(millis());
+  if (this->lost_sensor_)
+    this->lost_sensor_->publish_state(this->lost_);
+
+  uint8_t n = this->sample_count_;
+  if (n == 0)
+    return;
+  std::array<uint32_t, PROBE_SAMPLES> sorted = this->samples_;
+  std::sort(sorted.begin(), sorted.begin() + n);
+  // Nearest-rank percentiles
+  if (this->p50_sensor_)
+    this->p50_sensor_->publish_state(sorted[(n * 50 + 99) / 100 - 1]);
+  if (this->p95_sensor_)
+    this->p95_sensor_->publish_state(sorted[(n * 95 + 99) / 100 - 1]);
+}
+
+} // namespace sentio
+} // namespace esphome
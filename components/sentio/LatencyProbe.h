@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+
+#include "esphome.h"
+#include "esphome/core/automation.h"
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome {
+namespace sentio {
+
+static const uint8_t PROBE_MAX_PENDING = 4; // Probes awaiting their echo
+static const uint8_t PROBE_SAMPLES = 32;    // Round trips kept for p50/p95
+
+// Round trip through Home Assistant, measured from Sentio's input frame.
+// A tap inside the region runs on_probe with a sequence number instead of
+// on_tap; the automation sends it to HA (homeassistant.event), HA writes it
+// back to the echo sensor, and the time from the tap's frame to the echo is
+// one sample. Any automation that echoes the number back locally stands in
+// for HA, which leaves only Sentio's own share of the delay.
+class LatencyProbe {
+public:
+  LatencyProbe(int16_t x, int16_t y, int16_t w, int16_t h)
+      : x_(x), y_(y), width_(w), height_(h) {}
+
+  void set_echo_sensor(sensor::Sensor *s) {
+    s->add_on_state_callback([this](float value) { this->on_echo_(value); });
+  }
+  void set_timeout(uint32_t ms) { timeout_ms_ = ms; }
+  void set_last_sensor(sensor::Sensor *s) { last_sensor_ = s; }
+  void set_p50_sensor(sensor::Sensor *s) { p50_sensor_ = s; }
+  void set_p95_sensor(sensor::Sensor *s) { p95_sensor_ = s; }
+  void set_lost_sensor(sensor::Sensor *s) { lost_sensor_ = s; }
+  Trigger<uint32_t> *get_probe_trigger() { return &on_probe_; }
+
+  bool contains(int16_t x, int16_t y) const {
+    return x >= x_ && y >= y_ && x < x_ + width_ && y < y_ + height_;
+  }
+  // input_time: millis() of the frame that completed the tap
+  void send(uint32_t input_time);
+  // Percentiles over the recent samples (diagnostics interval)
+  void publish();
+
+  uint32_t get_sent() const { return sent_; }
+  uint32_t get_lost() const { return lost_; }
+
+protected:
+  struct Pending {
+    uint16_t seq;
+    uint32_t t;
+    bool active;
+  };
+
+  void on_echo_(float value);
+  void expire_(uint32_t now);
+
+  int16_t x_, y_, width_, height_;
+  uint32_t timeout_ms_{5000};
+  Trigger<uint32_t> on_probe_;
+
+  std::array<Pending, PROBE_MAX_PENDING> pending_{};
+  uint16_t next_seq_{1}; // Echo sensors start at 0 or NaN: never a valid seq
+
+  std::array<uint32_t, PROBE_SAMPLES> samples_{}; // Ring of round trips, ms
+  uint8_t sample_head_{0}, sample_count_{0};
+  uint32_t sent_{0}, lost_{0};
+
+  sensor::Sensor *last_sensor_{nullptr};
+  sensor::Sensor *p50_sensor_{nullptr};
+  sensor::Sensor *p95_sensor_{nullptr};
+  sensor::Sensor *lost_sensor_{nullptr};
+};
+
+} // namespace sentio
+} // namespace esphome
@@ -0,0 +1,32 @@
+#include "Placement.h"
+
+#include "esphome/core/log.h"
+
+#ifdef USE_ESP32
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_memory_utils.h>
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+#endif
+
+namespace esphome {
+namespace sentio {
+
+void log_placement(const char *what, const void *buffer, size_t bytes) {
+  if (buffer == nullptr) {
+    ESP_LOGW("Sentio", "%s: could not allocate %u bytes, disabled", what,
+             unsigned(bytes));
+    return;
+  }
+  const char *where = "internal RAM";
+#ifdef USE_ESP32
+  if (esp_ptr_external_ram(buffer))
+    where = "PSRAM";
+#endif
+  ESP_LOGI("Sentio", "%s: %u bytes in %s", what, unsigned(bytes), where);
+}
+
+} // namespace sentio
+} // namespace esphome
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+// Memory placement for the per-frame path (iram_hot_path in YAML, ESP32
+// only). SENTIO_HOT puts a function in IRAM and SENTIO_HOT_DATA a constant
+// table in DRAM. After a flash write (preferences, OTA) the flash cache starts
+// cold; code and tables here don't refill it, so the first frames don't stall.
+#if defined(USE_SENTIO_IRAM) && defined(USE_ESP32)
+#define SENTIO_HOT IRAM_ATTR
+#define SENTIO_HOT_DATA DRAM_ATTR
+#else
+#define SENTIO_HOT
+#define SENTIO_HOT_DATA
+#endif
+
+namespace esphome {
+namespace sentio {
+
+// Where a large, rarely written buffer goes (`placement:` on the buffer's
+// YAML block). Per-frame state and buffers written every frame (the stage and
+// trace-stream rings) stay in internal RAM.
+enum BufferPlacement : uint8_t {
+  PLACEMENT_AUTO,     // PSRAM from PSRAM_MIN_BYTES up, when the board has it
+  PLACEMENT_INTERNAL, // Internal RAM, leaving PSRAM to others
+  PLACEMENT_PSRAM,    // PSRAM when the board has it, whatever the size
+};
+
+static const size_t PSRAM_MIN_BYTES = 1024;
+
+// n uninitialised Ts, or nullptr. Either kind of RAM is used if the
+// preferred one is missing or full. Call at setup, never per frame.
+template<class T> T *place_buffer(size_t n, BufferPlacement placement) {
+  bool psram = placement == PLACEMENT_PSRAM ||
+               (placement == PLACEMENT_AUTO &&
+                n * sizeof(T) >= PSRAM_MIN_BYTES);
+  RAMAllocator<T> allocator(psram ? RAMAllocator<T>::ALLOC_EXTERNAL |
+                                        RAMAllocator<T>::ALLOC_INTERNAL
+                                  : RAMAllocator<T>::ALLOC_INTERNAL);
+  return allocator.allocate(n);
+}
+
+// Boot report line: "<what>: <bytes> bytes in PSRAM / internal RAM"
+void log_placement(const char *what, const void *buffer, size_t bytes);
+
+} // namespace sentio
+} // namespace esphome
@@ -1,24 +1,161 @@
 #include "Sentio.h"
 
+#ifdef USE_SENTIO_BENCHMARK
+#include "esphome/core/application.h"
+#endif
+
+#ifdef USE_SENTIO_SOAK
+#include <cmath>
+#if defined(USE_HOST)
+#include <cstdlib>
+#include <malloc.h>
+#elif defined(USE_ESP32)
+#include <esp_heap_caps.h>
+#endif
+#endif
+
 namespace esphome {
 namespace sentio {
 
-static const int SWIPE_THRESHOLD = 30; // Pixels to trigger a swipe
-static const int MAX_TAP_TIME = 400; // Max ms for a tap (otherwise it's a hold)
+static const uint8_t SLEEP_MODEL_VERSION = 1;
+static const uint32_t MAX_FRAME_INTERVAL_US = 250000; // Longer is a pause
+static const uint32_t DIAGNOSTICS_INTERVAL = 15000;
+static const uint32_t BACKPRESSURE_LAG = 3; // Read intervals without a read
+static const uint32_t BACKPRESSURE_MIN_LAG_MS = 100;
+static const uint8_t BACKPRESSURE_RECOVERY_READS = 3;
+static const uint32_t READ_BURST_MS = 2; // Reads this close: same draw pass
+static const uint32_t EDGE_HOLD_MAX = 2000; // Consumer gone: stop waiting
+static const uint32_t WET_CONFIRM_MS = 300; // Evidence this long latches wet
+static const uint32_t WET_STUCK_MS = 3000;  // Multi-contact that never lifts
+static const int WET_DRIFT_PX = 40;         // ...and barely moves
+static const uint32_t TRIGGER_WARN_INTERVAL = 10000;
+static const uint32_t WAKE_DOUBLE_TAP_GAP = 400; // First lift to second press
+static const int WAKE_DOUBLE_TAP_SLOP = 60;      // Px between the two taps
+
+// Indexed by TriggerId; the YAML keys the automations come from
+static const char *const TRIGGER_NAMES[NUM_TRIGGERS] = {
+    "on_swipe_left", "on_swipe_right", "on_swipe_cancel", "on_tap",
+    "on_wake",       "on_sleep",       "on_key",          "on_probe",
+};
 
-void SmartTouchComponent::setup() { this->last_activity_time_ = millis(); }
+// Precomputed per report-rate band; the last one is the pre-detection default
+static const RateProfile RATE_PROFILES[] SENTIO_HOT_DATA = {
+    {40, 2},         // Polled resistive (XPT2046 ~30Hz)
+    {75, 3},         // Typical capacitive polling (~60Hz)
+    {UINT16_MAX, 4}, // Interrupt-driven (GT911 on INT, 100Hz+)
+};
+static const size_t NUM_RATE_PROFILES =
+    sizeof(RATE_PROFILES) / sizeof(RATE_PROFILES[0]);
+
+void SmartTouchComponent::setup() {
+  // Only what the first touch needs. Anything touching flash or building
+  // tables runs from run_deferred_init_() once the panel is idle.
+  this->hot_.last_activity_time = millis();
+  this->hot_.rate_profile = &RATE_PROFILES[NUM_RATE_PROFILES - 1];
+  if (this->wet_sensor_)
+    this->wet_sensor_->publish_state(false);
+#ifdef USE_SENTIO_STAGE_TRACE
+  this->stage_trace_.init(this->stage_trace_events_);
+  this->stage_trace_.log_placement();
+#endif
+  for (auto *kb : this->keyboards_)
+    kb->log_placement();
+#ifdef USE_SENTIO_IRAM
+  ESP_LOGI("Sentio", "Hot path in IRAM; frame state %u bytes, config %u bytes",
+           unsigned(sizeof(this->hot_)), unsigned(sizeof(this->config_)));
+#endif
+}
+
+void SmartTouchComponent::run_deferred_init_() {
+  switch (this->init_stage_) {
+  case INIT_RESTORE_SLEEP_MODEL:
+    if (this->adaptive_sleep_)
+      this->restore_sleep_model_();
+    break;
+
+  case INIT_RESTORE_KEYBOARDS:
+    for (auto *kb : this->keyboards_)
+      kb->restore();
+    break;
 
-void SmartTouchComponent::loop() {
+  default:
+    return;
+  }
+  this->init_stage_ = static_cast<InitStage>(this->init_stage_ + 1);
+}
+
+void SENTIO_HOT SmartTouchComponent::loop() {
   if (this->source_driver_ == nullptr)
     return;
 
+#ifdef USE_SENTIO_BENCHMARK
+  if (this->bench_iterations_ > 0) {
+    uint16_t iterations = this->bench_iterations_;
+    this->bench_iterations_ = 0; // The workloads call loop() themselves
+    this->run_benchmark_(iterations);
+  }
+#endif
+#ifdef USE_SENTIO_SOAK
+  if (this->soak_.days > 0)
+    this->soak_step_();
+#endif
+
+#ifdef USE_SENTIO_STAGE_TRACE
+  // Idle passes would flush a whole gesture out of the ring in seconds
+  this->stage_trace_.set_armed(!this->source_driver_->touches.empty() ||
+                               this->hot_.state != STATE_IDLE);
+#endif
+  SENTIO_STAGE(STAGE_LOOP);
+
+  if (this->boot_to_ready_ms_ == 0) {
+    this->boot_to_ready_ms_ = std::max<uint32_t>(1, millis());
+    ESP_LOGI("Sentio", "Ready for input %ums after boot",
+             this->boot_to_ready_ms_);
+  }
+
+#ifdef USE_SENTIO_TRACE_STREAM
+  this->trace_.flush(millis());
+#endif
+
+  if (millis() - this->last_diagnostics_time_ > DIAGNOSTICS_INTERVAL) {
+    this->last_diagnostics_time_ = millis();
+    this->publish_diagnostics_();
+  }
+
+  this->update_backpressure_();
+
   // 1. SLEEP CHECK
-  if (millis() - this->last_activity_time_ > this->sleep_timeout_ms_) {
-    if (!this->is_sleeping_) {
-      this->is_sleeping_ = true;
+  if (millis() - this->hot_.last_activity_time > this->sleep_timeout_ms_) {
+    if (!this->hot_.is_sleeping) {
+      this->hot_.is_sleeping = true;
+      this->prewoken_ = false;
+      this->sleep_start_time_ = millis();
+      this->wake_gesture_ = {};
+      this->set_sleep_polling_(true);
       ESP_LOGI("Sentio", "Entering Sleep Mode");
-      if (this->on_sleep_)
-        this->on_sleep_->trigger();
+      // Model isn't restored yet (panel never idle): don't overwrite it
+      if (this->adaptive_sleep_ &&
+          this->init_stage_ > INIT_RESTORE_SLEEP_MODEL)
+        this->update_sleep_model_();
+      // Same for learned key offsets: saving first would drop the stored ones
+      if (this->init_stage_ > INIT_RESTORE_KEYBOARDS) {
+        for (auto *kb : this->keyboards_)
+          kb->save();
+      }
+      this->fire_(this->on_sleep_, TRIGGER_SLEEP);
+    } else if (this->poll_interval_ms_ != 0) {
+      this->set_sleep_polling_(true); // Backs off as the sleep goes on
+    }
+  }
+
+  // Presence sensor saw someone coming: light up before the finger lands
+  if (this->prewake_pending_) {
+    this->prewake_pending_ = false;
+    if (this->hot_.is_sleeping) {
+      ESP_LOGI("Sentio", "Pre-wake from presence sensor");
+      this->wake_();
+      this->prewoken_ = true;
+      this->prewakes_++;
     }
   }
 
@@ -27,78 +164,749 @@ void SmartTouchComponent::loop() {
 
   // 3. RELEASE LOGIC (Finger up)
   if (src_touches.empty()) {
-    if (this->state_ != STATE_IDLE) {
+    this->multi_touch_ = false;
+    this->wet_evidence_ = false;
+    if (this->wet_ && millis() - this->wet_last_seen_ > this->water_clear_ms_)
+      this->end_wet_period_();
+    if (this->hot_.is_sleeping && this->wake_policy_ != WAKE_ANY)
+      this->check_wake_gesture_(nullptr, 0);
+    // Idle slice: finish startup work one stage at a time, then reshape
+    // keyboard grids (one cell row per slice) after learning moved a key
+    if (this->hot_.state == STATE_IDLE) {
+      if (this->init_stage_ != INIT_DONE) {
+        this->run_deferred_init_();
+      } else {
+        for (auto *kb : this->keyboards_) {
+          if (kb->needs_rebuild()) {
+            kb->rebuild_step();
+            break;
+          }
+        }
+      }
+    }
+
+    if (this->hot_.state != STATE_IDLE) {
+#ifdef USE_SENTIO_TRACE_STREAM
+      this->trace_.record_release(millis());
+#endif
       this->handle_release(); // Logic for Tap detection
-      this->state_ = STATE_IDLE;
+      this->hot_.state = STATE_IDLE;
 
       // Clear output to consumers
-      this->touches.clear();
+      this->output_release_();
 
       // Reset the wake-up trap
-      this->ignore_next_release_ = false;
+      this->hot_.ignore_next_release = false;
+
+      this->tracker_.reset();
+
+      // Between touches: safe point to retune for the measured rate
+      this->hot_.last_frame_us = 0;
+      this->select_rate_profile_();
     }
     return;
   }
 
   // 4. TOUCH DETECTED (Finger down)
-  auto raw_p = src_touches[0]; // Logic for single point
+  // First reported finger drives rate tracking and wake. Don't use operator[]
+  // here: on the node-based container it would insert an entry whenever id 0
+  // isn't an active finger.
+  auto raw_p = src_touches.begin()->second;
+  {
+    SENTIO_STAGE(STAGE_INGEST);
+    this->track_report_rate_(raw_p);
 
-  // --- DEBUGGING ---
-  if (this->debug_raw_) {
-    ESP_LOGD("Sentio", "Raw: x=%d y=%d", raw_p.x, raw_p.y);
+    // --- DEBUGGING ---
+#ifdef USE_SENTIO_TRACE_STREAM
+    // Bulk capture goes out as binary; the text path can't keep up
+    for (auto &kv : src_touches)
+      this->trace_.record_sample(TRACE_RAW, millis(), kv.second.id,
+                                 kv.second.x, kv.second.y);
+#else
+    if (this->config_.debug_raw) {
+      ESP_LOGD("Sentio", "Raw: x=%d y=%d", raw_p.x, raw_p.y);
+    }
+#endif
+  }
+
+  // 4b. WATER: a crowd of drifting contacts that never release. Swallowed
+  // before wake and before the activity timer, so rain neither lights the
+  // panel nor keeps it awake.
+  if (this->water_rejection_) {
+    SENTIO_STAGE(STAGE_FILTER);
+    if (this->check_water_(src_touches.size(), raw_p))
+      return;
   }
 
   // 5. WAKE LOGIC
-  if (this->is_sleeping_) {
-    this->is_sleeping_ = false;
-    this->last_activity_time_ = millis();
-    ESP_LOGI("Sentio", "Waking Up");
-    if (this->on_wake_)
-      this->on_wake_->trigger();
+  bool just_woke = false;
+  if (this->hot_.is_sleeping) {
+    // Found by a slow poll: the finger may have waited up to one interval.
+    // Back to full rate at once, so a gesture policy sees the whole gesture.
+    if (this->poll_interval_ms_ != 0) {
+      this->wake_poll_latency_ms_ = this->poll_interval_ms_;
+      this->set_sleep_polling_(false);
+    }
+    // Gesture policies: stay dark until the whole gesture is in
+    if (this->wake_policy_ != WAKE_ANY &&
+        !this->check_wake_gesture_(&raw_p, src_touches.size()))
+      return;
+    just_woke = true;
+    this->wake_();
+
+    // Woken right after blanking: the timeout was too short
+    if (millis() - this->sleep_start_time_ < this->rewake_window_ms_)
+      this->pending_quick_rewake_ = true;
 
-    if (this->suppress_wake_click_) {
-      this->ignore_next_release_ = true; // Set trap
-      return;                            // Swallow this frame
+    // A wake gesture is never input, whatever suppress_wake_click says
+    if (this->config_.suppress_wake_click || this->wake_policy_ != WAKE_ANY) {
+      this->hot_.ignore_next_release = true; // Set trap
+      return;                                // Swallow this frame
+    }
+  } else if (this->prewoken_ && this->hot_.state == STATE_IDLE) {
+    // First touch after a presence pre-wake: the screen was already lit
+    this->prewoken_ = false;
+    just_woke = true;
+    if (this->suppress_after_prewake_) {
+      this->hot_.ignore_next_release = true;
+      return;
     }
   }
 
+  // Idle gap before this press feeds the adaptive timeout
+  if (this->adaptive_sleep_ && !just_woke && this->hot_.state == STATE_IDLE &&
+      !this->hot_.ignore_next_release)
+    this->record_interaction_gap_(millis() - this->hot_.last_activity_time);
+
   // Reset timer
-  this->last_activity_time_ = millis();
+  this->hot_.last_activity_time = millis();
 
   // If trap is set (wake-up click), ignore everything until release
-  if (this->ignore_next_release_)
+  if (this->hot_.ignore_next_release)
     return;
 
-  // 6. CALIBRATE
-  auto p = this->apply_calibration(raw_p);
+  // 6. CALIBRATE (every finger, into fixed storage)
+  uint8_t count = 0;
+  {
+    SENTIO_STAGE(STAGE_CALIBRATE);
+    for (auto &kv : src_touches) {
+      if (count >= MAX_CONTACTS)
+        break;
+      this->hot_.frame[count++] = this->apply_calibration(kv.second);
+    }
+  }
+
+  // 6b. STABLE IDS: controllers may swap or reuse theirs between frames
+  {
+    SENTIO_STAGE(STAGE_FILTER);
+    this->tracker_.update(this->hot_.frame.data(), count, millis(),
+                          this->hot_.frame_ids.data());
+    for (uint8_t i = 0; i < count; i++) {
+      this->hot_.frame[i].id = this->hot_.frame_ids[i];
+#ifdef USE_SENTIO_TRACE_STREAM
+      this->trace_.record_sample(TRACE_PROCESSED, millis(),
+                                 this->hot_.frame[i].id, this->hot_.frame[i].x,
+                                 this->hot_.frame[i].y);
+#endif
+    }
+  }
 
-  // 7. GESTURE & DEBOUNCE ENGINE
-  this->process_gestures(p);
+  // 7. GESTURE & DEBOUNCE ENGINE (follows the first finger down)
+  if (this->hot_.state == STATE_IDLE)
+    this->hot_.primary_id = this->hot_.frame[0].id;
+  for (uint8_t i = 0; i < count; i++) {
+    if (this->hot_.frame[i].id == this->hot_.primary_id) {
+      this->hot_.last_point = this->hot_.frame[i];
+      this->process_gestures(this->hot_.frame[i]);
+      break;
+    }
+  }
 
   // 8. OUTPUT TO CONSUMERS (LVGL)
   // Only update LVGL if we passed the debounce check (handled in
   // process_gestures) For the MVP, we just pass it through, but ideally, we
   // wait `debounce_ms`
-  this->add_raw_touch_position_(p.id, p.x, p.y, p.pressure);
+  this->output_frame_(count);
+}
+
+void SENTIO_HOT SmartTouchComponent::output_frame_(uint8_t count) {
+  SENTIO_STAGE(STAGE_PUBLISH);
+  uint16_t mask = 0;
+  for (uint8_t i = 0; i < count; i++)
+    mask |= 1 << this->hot_.frame[i].id;
+
+  // LVGL polls the mirror on its own schedule and Sentio can't see when:
+  // it gets every frame, whatever the lambda readers are doing
+  if (this->config_.mirror_touches)
+    this->mirror_frame_(count, mask);
+
+  // The rest is the lambda view (slots, dirty rect, shared copy).
+  // A finger appeared or lifted since the last published frame.
+  this->frames_since_read_++;
+  bool edge = mask != this->hot_.published_mask;
+
+  if (this->backpressure_) {
+    // Coalesce: one position update per consumer read, latest wins. An edge
+    // waits until the consumer has seen the previous one.
+    bool waiting = this->release_deferred_;
+    if (edge)
+      waiting |= this->consumer_reads_ == this->reads_at_edge_ &&
+                 millis() - this->edge_time_ < EDGE_HOLD_MAX;
+    else
+      waiting |= this->consumer_reads_ == this->reads_at_publish_;
+    if (waiting) {
+      this->coalesced_frames_++;
+      return;
+    }
+  }
+
+  this->publish_frame_(count);
+  this->reads_at_publish_ = this->consumer_reads_;
+  if (edge) {
+    this->reads_at_edge_ = this->consumer_reads_;
+    this->edge_time_ = millis();
+  }
+
+  // A reader that has stopped keeping its own pace (not just a slow one: a
+  // 1s display is steady at 1s) while frames wait for it: throttle
+  uint32_t lag = std::max(BACKPRESSURE_LAG * this->read_interval_ms_,
+                          BACKPRESSURE_MIN_LAG_MS);
+  if (!this->backpressure_ && this->read_interval_ms_ > 0 &&
+      this->frames_since_read_ > 1 && millis() - this->last_read_ms_ > lag) {
+    this->backpressure_ = true;
+    this->backpressure_start_ = millis();
+    this->backpressure_events_++;
+    this->steady_reads_ = 0;
+    SENTIO_TLOG("Consumer is slow, coalescing output");
+  }
+}
+
+void SmartTouchComponent::mirror_frame_(uint8_t count, uint16_t mask) {
+  // Update the existing nodes in place; only the first frame of a press
+  // inserts one
+  for (uint8_t i = 0; i < count; i++) {
+    const auto &p = this->hot_.frame[i];
+    auto it = this->touches.find(p.id);
+    if (it == this->touches.end()) {
+      this->add_raw_touch_position_(p.id, p.x, p.y, p.pressure);
+      continue;
+    }
+    it->second.x = p.x;
+    it->second.y = p.y;
+    it->second.pressure = p.pressure;
+  }
+  // Fingers that lifted while others stay down
+  for (auto it = this->touches.begin(); it != this->touches.end();) {
+    if (it->first < MAX_CONTACTS && (mask & (1 << it->first)))
+      ++it;
+    else
+      it = this->touches.erase(it);
+  }
+}
+
+void SmartTouchComponent::output_release_() {
+  SENTIO_STAGE(STAGE_PUBLISH);
+  if (this->config_.mirror_touches && !this->touches.empty())
+    this->touches.clear(); // LVGL sees the lift at once
+  if (this->hot_.published_mask == 0)
+    return; // Nothing was published (wake click, noise pulse)
+
+  // Never let a press vanish unseen: hold it until the consumer reads once
+  if (this->backpressure_ && this->consumer_reads_ == this->reads_at_edge_) {
+    this->release_deferred_ = true;
+    return;
+  }
+  this->release_contacts_();
+  this->reads_at_edge_ = this->consumer_reads_;
+  this->edge_time_ = millis();
+}
+
+void SmartTouchComponent::update_backpressure_() {
+#ifdef USE_SENTIO_SHARED_CONTACTS
+  // Other tasks can't touch the read counters; fold their reads in here
+  uint32_t shared_reads = this->shared_.get_reads();
+  if (shared_reads != this->shared_reads_seen_) {
+    this->shared_reads_seen_ = shared_reads;
+    this->note_consumer_read_();
+  }
+#endif
+
+  if (this->release_deferred_ &&
+      (this->consumer_reads_ != this->reads_at_edge_ ||
+       millis() - this->edge_time_ > EDGE_HOLD_MAX)) {
+    this->release_deferred_ = false;
+    this->release_contacts_();
+    this->reads_at_edge_ = this->consumer_reads_;
+    this->edge_time_ = millis();
+  }
+
+  if (this->backpressure_ && !this->release_deferred_ &&
+      this->steady_reads_ >= BACKPRESSURE_RECOVERY_READS) {
+    uint32_t duration = millis() - this->backpressure_start_;
+    this->backpressure_ms_total_ += duration;
+    this->backpressure_ = false;
+    SENTIO_TLOG("Consumer caught up after %ums (%u frames coalesced)",
+                duration, this->coalesced_frames_);
+  }
+}
+
+void SmartTouchComponent::note_consumer_read_() const {
+  this->consumer_reads_++;
+  this->frames_since_read_ = 0;
+  uint32_t now = millis();
+  uint32_t gap = now - this->last_read_ms_;
+  if (this->consumer_reads_ > 1 && gap < READ_BURST_MS)
+    return; // contacts() and take_dirty_rect() in one draw
+  this->last_read_ms_ = now;
+  if (this->consumer_reads_ == 1)
+    return;
+
+  // The reader's own cadence. A stall counts at most double, so a reader
+  // that really did slow down is followed within a few reads.
+  if (this->read_interval_ms_ == 0) {
+    this->read_interval_ms_ = gap;
+  } else {
+    bool steady = gap <= BACKPRESSURE_LAG * this->read_interval_ms_;
+    this->steady_reads_ = steady ? this->steady_reads_ + 1 : 0;
+    gap = std::min(gap, 2 * this->read_interval_ms_);
+    this->read_interval_ms_ = (3 * this->read_interval_ms_ + gap) / 4;
+  }
+}
+
+void SENTIO_HOT SmartTouchComponent::track_report_rate_(
+    const touchscreen::TouchPoint &raw) {
+  // The source only tells us about frames by changing the sample; a finger
+  // held perfectly still contributes nothing, which is fine for an average
+  bool first = this->hot_.last_frame_us == 0;
+  if (!first && raw.x == this->hot_.last_raw_x &&
+      raw.y == this->hot_.last_raw_y)
+    return;
+
+  uint32_t now = micros();
+  uint32_t interval = now - this->hot_.last_frame_us;
+  this->hot_.last_frame_us = now;
+  this->hot_.last_raw_x = raw.x;
+  this->hot_.last_raw_y = raw.y;
+  if (first || interval > MAX_FRAME_INTERVAL_US)
+    return;
+
+  if (this->hot_.frame_interval_us == 0) {
+    this->hot_.frame_interval_us = interval;
+    return;
+  }
+  int32_t error = int32_t(interval) - this->hot_.frame_interval_us;
+  this->hot_.frame_interval_us += error / 8;
+  this->hot_.frame_jitter_us += (abs(error) - this->hot_.frame_jitter_us) / 8;
+}
+
+void SmartTouchComponent::select_rate_profile_() {
+  if (this->hot_.frame_interval_us <= 0)
+    return;
+
+  uint32_t hz = 1000000 / this->hot_.frame_interval_us;
+  const RateProfile *profile = &RATE_PROFILES[NUM_RATE_PROFILES - 1];
+  for (const auto &band : RATE_PROFILES) {
+    if (hz <= band.max_hz) {
+      profile = &band;
+      break;
+    }
+  }
+  if (profile == this->hot_.rate_profile)
+    return;
+
+  ESP_LOGD("Sentio", "Report rate ~%uHz (jitter %.1fms): early window %u",
+           hz, this->get_report_jitter_ms(), profile->early_samples);
+  this->hot_.rate_profile = profile;
 }
 
-touchscreen::TouchPoint
+void SmartTouchComponent::publish_diagnostics_() {
+  if (this->hot_.frame_interval_us > 0) {
+    if (this->report_rate_sensor_)
+      this->report_rate_sensor_->publish_state(this->get_report_rate());
+    if (this->report_jitter_sensor_)
+      this->report_jitter_sensor_->publish_state(this->get_report_jitter_ms());
+  }
+
+  if (this->boot_to_ready_sensor_)
+    this->boot_to_ready_sensor_->publish_state(this->boot_to_ready_ms_);
+  if (this->backpressure_events_sensor_)
+    this->backpressure_events_sensor_->publish_state(
+        this->backpressure_events_);
+  if (this->backpressure_time_sensor_) {
+    uint32_t ms = this->backpressure_ms_total_;
+    if (this->backpressure_)
+      ms += millis() - this->backpressure_start_;
+    this->backpressure_time_sensor_->publish_state(ms / 1000.0f);
+  }
+  if (this->latency_probe_)
+    this->latency_probe_->publish();
+  if (this->trigger_time_max_sensor_) {
+    uint32_t max_us = 0;
+    for (const auto &s : this->trigger_stats_)
+      max_us = std::max(max_us, s.max_us);
+    this->trigger_time_max_sensor_->publish_state(max_us / 1000.0f);
+  }
+  if (this->wakes_prevented_sensor_)
+    this->wakes_prevented_sensor_->publish_state(this->wakes_prevented_);
+  if (this->sleep_poll_ms_ != 0) {
+    this->account_polls_(millis());
+    if (this->wake_poll_latency_sensor_)
+      this->wake_poll_latency_sensor_->publish_state(
+          this->wake_poll_latency_ms_);
+    if (this->sleep_poll_duty_sensor_)
+      this->sleep_poll_duty_sensor_->publish_state(this->get_sleep_poll_duty());
+  }
+}
+
+void SmartTouchComponent::record_interaction_gap_(uint32_t gap_ms) {
+  // Log2 buckets in seconds: [0,2s), [2s,4s), [4s,8s), ...
+  uint32_t secs = gap_ms / 1000;
+  uint8_t bucket = 0;
+  while (secs > 1 && bucket < SLEEP_GAP_BUCKETS - 1) {
+    secs >>= 1;
+    bucket++;
+  }
+  if (this->pending_gaps_[bucket] < UINT16_MAX)
+    this->pending_gaps_[bucket]++;
+}
+
+void SmartTouchComponent::update_sleep_model_() {
+  // Runs once per sleep event: fold in the gaps seen since the last one,
+  // aging the old history so the model follows changing habits
+  AdaptiveSleepModel &m = this->sleep_model_;
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < SLEEP_GAP_BUCKETS; i++) {
+    uint32_t aged = m.gaps[i] - m.gaps[i] / 8 + this->pending_gaps_[i];
+    m.gaps[i] = std::min<uint32_t>(aged, UINT16_MAX);
+    this->pending_gaps_[i] = 0;
+    total += m.gaps[i];
+  }
+
+  uint32_t timeout = this->sleep_timeout_ms_;
+  if (this->pending_quick_rewake_) {
+    // Premature sleep: back off quickly
+    timeout += timeout / 2;
+    if (m.quick_rewakes < UINT16_MAX)
+      m.quick_rewakes++;
+  } else if (total > 0) {
+    // Aim for twice the 90th percentile idle gap, approached gradually
+    uint32_t seen = 0;
+    uint8_t p90 = 0;
+    for (; p90 < SLEEP_GAP_BUCKETS - 1; p90++) {
+      seen += m.gaps[p90];
+      if (seen * 10 >= total * 9)
+        break;
+    }
+    uint32_t target = (2000u << p90) * 2; // Bucket upper edge, doubled
+    if (target > timeout)
+      timeout += (target - timeout) / 4;
+    else
+      timeout -= (timeout - target) / 4;
+  }
+  this->pending_quick_rewake_ = false;
+
+  timeout = std::max(this->min_sleep_timeout_ms_,
+                     std::min(this->max_sleep_timeout_ms_, timeout));
+  if (timeout != this->sleep_timeout_ms_)
+    ESP_LOGD("Sentio", "Adaptive sleep timeout: %ums -> %ums",
+             this->sleep_timeout_ms_, timeout);
+  this->sleep_timeout_ms_ = timeout;
+
+  m.version = SLEEP_MODEL_VERSION;
+  m.timeout_ms = timeout;
+  if (m.sleeps < UINT16_MAX)
+    m.sleeps++;
+  this->sleep_pref_.save(&m);
+}
+
+void SmartTouchComponent::restore_sleep_model_() {
+  this->sleep_pref_ = global_preferences->make_preference<AdaptiveSleepModel>(
+      fnv1_hash("sentio_adaptive_sleep"));
+
+  AdaptiveSleepModel m{};
+  if (!this->sleep_pref_.load(&m) || m.version != SLEEP_MODEL_VERSION)
+    return;
+
+  this->sleep_model_ = m;
+  this->sleep_timeout_ms_ =
+      std::max(this->min_sleep_timeout_ms_,
+               std::min(this->max_sleep_timeout_ms_, m.timeout_ms));
+  ESP_LOGD("Sentio", "Restored adaptive sleep timeout: %ums (%u sleeps)",
+           this->sleep_timeout_ms_, m.sleeps);
+}
+
+void SENTIO_HOT SmartTouchComponent::publish_frame_(uint8_t count) {
+  uint16_t seen = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    const auto &p = this->hot_.frame[i];
+    seen |= 1 << p.id;
+
+    // Stable IDs index the slots directly
+    Contact &c = this->contacts_[p.id];
+    if (c.active)
+      this->mark_dirty_(c.point.x, c.point.y); // Trail: where it was drawn
+    this->mark_dirty_(p.x, p.y);
+    c.point = p;
+    c.active = true;
+  }
+
+  // Fingers that lifted while others stay down
+  for (uint8_t s = 0; s < MAX_CONTACTS; s++) {
+    Contact &c = this->contacts_[s];
+    if (!c.active || (seen & (1 << s)))
+      continue;
+    this->mark_dirty_(c.point.x, c.point.y);
+    c.active = false;
+  }
+  this->hot_.published_mask = seen;
+#ifdef USE_SENTIO_SHARED_CONTACTS
+  this->share_contacts_();
+#endif
+}
+
+void SmartTouchComponent::release_contacts_() {
+  for (auto &c : this->contacts_) {
+    if (c.active)
+      this->mark_dirty_(c.point.x, c.point.y); // Erase the last position
+    c.active = false;
+  }
+
+  this->hot_.published_mask = 0;
+#ifdef USE_SENTIO_SHARED_CONTACTS
+  this->share_contacts_();
+#endif
+}
+
+#ifdef USE_SENTIO_SHARED_CONTACTS
+void SmartTouchComponent::share_contacts_() {
+  this->shared_.begin_write();
+  for (uint8_t s = 0; s < MAX_CONTACTS; s++) {
+    if (this->hot_.published_mask & (1 << s))
+      this->shared_.store(s, this->contacts_[s].point);
+  }
+  this->shared_.end_write(this->hot_.published_mask);
+}
+
+uint32_t SmartTouchComponent::read_contacts(
+    std::array<Contact, MAX_CONTACTS> &out) const {
+  touchscreen::TouchPoint points[MAX_CONTACTS];
+  uint16_t active;
+  uint32_t seq = this->shared_.read(points, active);
+  for (uint8_t s = 0; s < MAX_CONTACTS; s++) {
+    out[s].point = points[s];
+    out[s].active = active & (1 << s);
+  }
+  return seq;
+}
+#endif
+
+bool SENTIO_HOT SmartTouchComponent::check_water_(
+    size_t count, const touchscreen::TouchPoint &raw) {
+  uint32_t now = millis();
+
+  if (count < 2) {
+    this->multi_touch_ = false;
+  } else if (!this->multi_touch_) {
+    this->multi_touch_ = true;
+    this->multi_start_ = now;
+    this->multi_x_ = raw.x;
+    this->multi_y_ = raw.y;
+  }
+
+  bool crowd = count >= this->water_min_contacts_;
+  bool stuck = this->multi_touch_ && now - this->multi_start_ > WET_STUCK_MS &&
+               abs(raw.x - this->multi_x_) + abs(raw.y - this->multi_y_) <
+                   WET_DRIFT_PX;
+
+  if (crowd || stuck) {
+    if (!this->wet_evidence_) {
+      this->wet_evidence_ = true;
+      this->wet_evidence_start_ = now;
+    }
+    if (!this->wet_ && now - this->wet_evidence_start_ >= WET_CONFIRM_MS)
+      this->start_wet_period_();
+  } else {
+    this->wet_evidence_ = false;
+  }
+
+  // While wet, anything on the glass keeps it wet: it clears only after a
+  // clean release lasting water_clear_ms_
+  if (this->wet_) {
+    this->wet_last_seen_ = now;
+    return true;
+  }
+  // Not confirmed yet, but a crowd is never real input for this UI
+  return crowd;
+}
+
+void SmartTouchComponent::start_wet_period_() {
+  this->wet_ = true;
+  this->wet_start_ = millis();
+  this->wet_last_seen_ = this->wet_start_;
+  this->wet_periods_++;
+  ESP_LOGW("Sentio", "Water detected on panel, suppressing input");
+  if (this->wet_sensor_)
+    this->wet_sensor_->publish_state(true);
+
+  // Drop the gesture in flight without reporting a tap or swipe release
+  if (this->hot_.state != STATE_IDLE) {
+    this->hot_.state = STATE_IDLE;
+    this->hot_.early_committed = false;
+    this->release_contacts_();
+    if (this->config_.mirror_touches)
+      this->touches.clear();
+    this->tracker_.reset();
+  }
+  this->hot_.ignore_next_release = false;
+}
+
+void SmartTouchComponent::end_wet_period_() {
+  uint32_t duration = millis() - this->wet_start_;
+  this->wet_ = false;
+  this->wet_ms_total_ += duration;
+  ESP_LOGI("Sentio", "Panel dry again after %ums", duration);
+  if (this->wet_sensor_)
+    this->wet_sensor_->publish_state(false);
+}
+
+void SmartTouchComponent::wake_() {
+  this->hot_.is_sleeping = false;
+  this->hot_.last_activity_time = millis();
+  this->set_sleep_polling_(false);
+  ESP_LOGI("Sentio", "Waking Up");
+  this->fire_(this->on_wake_, TRIGGER_WAKE);
+}
+
+// Called while asleep with the first reported contact, or nullptr when
+// nothing touches the panel. True once the wake gesture is complete.
+bool SmartTouchComponent::check_wake_gesture_(
+    const touchscreen::TouchPoint *raw, size_t count) {
+  WakeGesture &g = this->wake_gesture_;
+  uint32_t now = millis();
+  int threshold = this->config_.swipe_threshold;
+
+  if (raw == nullptr) {
+    if (g.down) {
+      // Lifted: only a clean tap may still be the start of a double tap
+      g.down = false;
+      bool tap = !g.stray && now - g.down_time <= this->config_.max_tap_time;
+      if (this->wake_policy_ == WAKE_DOUBLE_TAP && tap && !g.tap_pending) {
+        g.tap_pending = true;
+        g.tap_time = now;
+        g.tap_x = g.x;
+        g.tap_y = g.y;
+      } else {
+        this->reject_wake_();
+      }
+    } else if (g.tap_pending && now - g.tap_time > WAKE_DOUBLE_TAP_GAP) {
+      this->reject_wake_(); // A lone tap
+    }
+    // Full rate only while a gesture may be under way
+    if (!g.tap_pending)
+      this->set_sleep_polling_(true);
+    return false;
+  }
+
+  touchscreen::TouchPoint p = this->apply_calibration(*raw);
+  if (!g.down) {
+    g.down = true;
+    g.stray = false;
+    g.down_time = now;
+    g.x = p.x;
+    g.y = p.y;
+    if (g.tap_pending &&
+        (now - g.tap_time > WAKE_DOUBLE_TAP_GAP ||
+         abs(p.x - g.tap_x) > WAKE_DOUBLE_TAP_SLOP ||
+         abs(p.y - g.tap_y) > WAKE_DOUBLE_TAP_SLOP)) {
+      // Too late or too far to pair with the first tap, but may be the
+      // first tap of a new pair
+      this->reject_wake_();
+      g.down = true;
+      g.down_time = now;
+      g.x = p.x;
+      g.y = p.y;
+    }
+  }
+
+  int dx = p.x - g.x;
+  int dy = p.y - g.y;
+  if (count > 1 || abs(dx) > threshold || abs(dy) > threshold)
+    g.stray = true;
+
+  switch (this->wake_policy_) {
+  case WAKE_DOUBLE_TAP:
+    // Wake on the second press; the trap swallows the rest of it
+    return g.tap_pending && count == 1;
+  case WAKE_HOLD:
+    return !g.stray && now - g.down_time >= this->wake_hold_ms_;
+  case WAKE_SWIPE_UP:
+    return count == 1 && -dy >= threshold && -dy > 2 * abs(dx);
+  default:
+    return true;
+  }
+}
+
+void SmartTouchComponent::reject_wake_() {
+  this->wake_gesture_ = {};
+  this->wakes_prevented_++;
+  ESP_LOGD("Sentio", "Not a wake gesture (%u prevented)",
+           this->wakes_prevented_);
+}
+
+void SmartTouchComponent::set_sleep_polling_(bool slow) {
+  if (this->sleep_poll_ms_ == 0)
+    return;
+  uint32_t interval = 0;
+  if (slow) {
+    // Doubles every backoff period asleep, up to the ceiling
+    interval = this->sleep_poll_ms_;
+    uint32_t asleep = millis() - this->sleep_start_time_;
+    uint32_t doublings = this->sleep_poll_backoff_ms_ > 0
+                             ? asleep / this->sleep_poll_backoff_ms_
+                             : 0;
+    while (doublings-- > 0 && interval < this->sleep_poll_max_ms_)
+      interval = std::min(interval * 2, this->sleep_poll_max_ms_);
+  }
+  if (interval == this->poll_interval_ms_)
+    return;
+
+  uint32_t now = millis();
+  if (this->poll_interval_ms_ == 0)
+    this->source_poll_ms_ = this->source_driver_->get_update_interval();
+  this->account_polls_(now);
+  this->poll_interval_ms_ = interval;
+  this->source_driver_->set_update_interval(interval ? interval
+                                                     : this->source_poll_ms_);
+  this->source_driver_->start_poller(); // Re-arms it at the new interval
+}
+
+void SmartTouchComponent::account_polls_(uint32_t now) {
+  if (this->poll_interval_ms_ != 0 && this->source_poll_ms_ != 0) {
+    float ms = now - this->poll_since_;
+    this->polls_slow_ += ms / this->poll_interval_ms_;
+    this->polls_full_ += ms / this->source_poll_ms_;
+  }
+  this->poll_since_ = now;
+}
+
+touchscreen::TouchPoint SENTIO_HOT
 SmartTouchComponent::apply_calibration(touchscreen::TouchPoint p) {
   int x = p.x;
   int y = p.y;
 
   // 1. Swap
-  if (this->swap_xy_)
+  if (this->config_.swap_xy)
     std::swap(x, y);
 
   // 2. Invert (Requires display resolution)
   // Note: If swapped, x is now relative to the *height* dimension
-  int width = this->swap_xy_ ? this->display_height_ : this->display_width_;
-  int height = this->swap_xy_ ? this->display_width_ : this->display_height_;
+  const Config &cfg = this->config_;
+  int width = cfg.swap_xy ? cfg.display_height : cfg.display_width;
+  int height = cfg.swap_xy ? cfg.display_width : cfg.display_height;
 
-  if (this->invert_x_)
+  if (this->config_.invert_x)
     x = width - x;
-  if (this->invert_y_)
+  if (this->config_.invert_y)
     y = height - y;
 
   // Clamp to 0
@@ -112,74 +920,467 @@ SmartTouchComponent::apply_calibration(touchscreen::TouchPoint p) {
   return p;
 }
 
-void SmartTouchComponent::process_gestures(touchscreen::TouchPoint p) {
-  switch (this->state_) {
+void SENTIO_HOT
+SmartTouchComponent::process_gestures(touchscreen::TouchPoint p) {
+  SENTIO_STAGE(STAGE_RECOGNIZE);
+  uint32_t now = millis();
+
+  switch (this->hot_.state) {
   case STATE_IDLE:
     // Start of a touch
-    this->state_ = STATE_START;
-    this->start_x_ = p.x;
-    this->start_y_ = p.y;
-    this->gesture_start_time_ = millis();
+    this->hot_.state = STATE_START;
+    this->hot_.start_x = p.x;
+    this->hot_.start_y = p.y;
+    this->hot_.gesture_start_time = now;
+    this->hot_.early_committed = false;
+    this->hot_.gesture_cancelled = false;
+    this->hot_.sample_count = 0;
+    this->push_sample_(p, now);
     break;
 
-  case STATE_START:
+  case STATE_START: {
     // Check for Swipe
-    int dx = p.x - this->start_x_;
-    int dy = p.y - this->start_y_;
+    int dx = p.x - this->hot_.start_x;
+    this->push_sample_(p, now);
 
     // Horizontal Swipe Detection
-    if (abs(dx) > SWIPE_THRESHOLD) {
-      this->state_ = STATE_DRAGGING;
-      if (dx > 0) {
-        if (this->on_swipe_right_)
-          this->on_swipe_right_->trigger();
-      } else {
-        if (this->on_swipe_left_)
-          this->on_swipe_left_->trigger();
+    if (abs(dx) > this->config_.swipe_threshold) {
+      this->hot_.state = STATE_DRAGGING;
+      this->fire_swipe_(dx > 0 ? 1 : -1);
+    } else if (this->config_.early_swipe && !this->hot_.gesture_cancelled) {
+      int8_t dir = this->predict_swipe_();
+      if (dir != 0) {
+        this->hot_.state = STATE_DRAGGING;
+        this->hot_.early_committed = true;
+        this->hot_.early_dir = dir;
+        this->hot_.early_commit_time = now;
+        this->early_commits_++;
+        this->fire_swipe_(dir);
       }
     }
     break;
+  }
+
+  case STATE_DRAGGING: {
+    // We already triggered the swipe, just wait for release. An early commit
+    // is still a prediction until the finger crosses the real threshold.
+    if (!this->hot_.early_committed)
+      break;
+    int dx = p.x - this->hot_.start_x;
+    if (dx * this->hot_.early_dir > this->config_.swipe_threshold) {
+      uint32_t lead = now - this->hot_.early_commit_time;
+      this->early_lead_ms_total_ += lead;
+      this->hot_.early_committed = false;
+      SENTIO_TLOG("Early swipe confirmed %ums ahead of threshold", lead);
+    } else if (dx * this->hot_.early_dir < 0) {
+      // Finger went the other way: take it back and resume normal detection
+      this->retract_swipe_();
+      this->hot_.state = STATE_START;
+    }
+    break;
+  }
 
-  case STATE_DRAGGING:
-    // We already triggered the swipe, just wait for release
+  default:
     break;
   }
 }
 
+void SENTIO_HOT SmartTouchComponent::push_sample_(
+    const touchscreen::TouchPoint &p, uint32_t now) {
+  if (this->hot_.sample_count >= EARLY_SWIPE_SAMPLES)
+    return;
+  this->hot_.samples[this->hot_.sample_count++] = {p.x, p.y, now};
+}
+
+int8_t SENTIO_HOT SmartTouchComponent::predict_swipe_() {
+  // Only the first few samples carry intent; after that the threshold decides
+  uint8_t n = this->hot_.sample_count;
+  if (n < 2 || n > this->hot_.rate_profile->early_samples)
+    return 0;
+
+  const Sample &first = this->hot_.samples[0];
+  const Sample &last = this->hot_.samples[n - 1];
+  int dx = last.x - first.x;
+  int dy = last.y - first.y;
+  uint32_t dt = last.t - first.t;
+
+  // Ignore jitter: a flick has to travel a meaningful distance first
+  if (dt == 0 || abs(dx) < this->config_.swipe_threshold / 3)
+    return 0;
+
+  // Direction consistency: every step must move the same way, mostly sideways
+  int consistent = 0;
+  for (uint8_t i = 1; i < n; i++) {
+    int sx = this->hot_.samples[i].x - this->hot_.samples[i - 1].x;
+    int sy = this->hot_.samples[i].y - this->hot_.samples[i - 1].y;
+    if (sx * dx > 0 && abs(sx) >= abs(sy))
+      consistent++;
+  }
+  float consistency = float(consistent) / float(n - 1);
+
+  float speed = float(abs(dx)) / float(dt); // px/ms
+  float speed_score =
+      std::min(1.0f, speed / this->config_.early_swipe_velocity);
+  float straightness = float(abs(dx)) / float(abs(dx) + abs(dy));
+
+  float confidence = consistency * speed_score * straightness;
+  if (confidence < this->config_.early_swipe_confidence)
+    return 0;
+  return dx > 0 ? 1 : -1;
+}
+
+void SmartTouchComponent::fire_(Trigger<> *trigger, TriggerId id) {
+  if (trigger == nullptr)
+    return;
+  SENTIO_STAGE(STAGE_TRIGGER);
+  uint32_t start = micros();
+  trigger->trigger();
+  this->record_trigger_time_(id, micros() - start);
+}
+
+void SmartTouchComponent::record_trigger_time_(TriggerId id, uint32_t us) {
+  TriggerStats &s = this->trigger_stats_[id];
+  s.count++;
+  s.total_us += us;
+  s.max_us = std::max(s.max_us, us);
+  if (us <= this->trigger_budget_us_)
+    return;
+
+  s.over_budget++;
+  this->trigger_overruns_++;
+  // A slow automation on every tap would otherwise flood the log
+  uint32_t now = millis();
+  if (this->trigger_overruns_logged_ != 0 &&
+      now - this->last_trigger_warning_ < TRIGGER_WARN_INTERVAL)
+    return;
+  ESP_LOGW("Sentio",
+           "%s automation took %.1fms (budget %.1fms, mean %.1fms); "
+           "%u overruns since the last warning",
+           TRIGGER_NAMES[id], us / 1000.0f, this->trigger_budget_us_ / 1000.0f,
+           s.mean_us() / 1000.0f,
+           this->trigger_overruns_ - this->trigger_overruns_logged_);
+  this->trigger_overruns_logged_ = this->trigger_overruns_;
+  this->last_trigger_warning_ = now;
+}
+
+void SmartTouchComponent::log_trigger_stats() const {
+  for (uint8_t i = 0; i < NUM_TRIGGERS; i++) {
+    const TriggerStats &s = this->trigger_stats_[i];
+    if (s.count == 0)
+      continue;
+    ESP_LOGI("Sentio", "%-16s %6u runs, mean %.2fms, max %.2fms, %u over budget",
+             TRIGGER_NAMES[i], s.count, s.mean_us() / 1000.0f,
+             s.max_us / 1000.0f, s.over_budget);
+  }
+}
+
+void SmartTouchComponent::fire_swipe_(int8_t dir) {
+  if (dir > 0)
+    this->fire_(this->on_swipe_right_, TRIGGER_SWIPE_RIGHT);
+  else
+    this->fire_(this->on_swipe_left_, TRIGGER_SWIPE_LEFT);
+}
+
+void SmartTouchComponent::retract_swipe_() {
+  this->hot_.early_committed = false;
+  this->hot_.gesture_cancelled = true;
+  this->early_retractions_++;
+  SENTIO_TLOG("Early swipe retracted (%u of %u commits)",
+              this->early_retractions_, this->early_commits_);
+  this->fire_(this->on_swipe_cancel_, TRIGGER_SWIPE_CANCEL);
+}
+
 void SmartTouchComponent::handle_release() {
+  SENTIO_STAGE(STAGE_RECOGNIZE);
+  // Lifted before the threshold: the early prediction was wrong
+  if (this->hot_.early_committed) {
+    this->retract_swipe_();
+    return;
+  }
+
   // If we are releasing, and we never left STATE_START, it's a TAP
-  if (this->state_ == STATE_START) {
-    uint32_t duration = millis() - this->gesture_start_time_;
+  if (this->hot_.state == STATE_START && !this->hot_.gesture_cancelled) {
+    uint32_t duration = millis() - this->hot_.gesture_start_time;
 
     // Ghost Touch Filter: If touch was too short (WiFi noise), ignore it
-    if (duration < this->debounce_ms_) {
-      ESP_LOGD("Sentio", "Ignored noise pulse (<%dms)", this->debounce_ms_);
-      // Also clear the 'touches' buffer so LVGL doesn't see it
-      this->touches.clear();
+    if (duration < this->config_.debounce_ms) {
+      SENTIO_TLOG("Ignored noise pulse (<%ums)", this->config_.debounce_ms);
+      // Also clear the output slots so LVGL doesn't see it
+      this->release_contacts_();
+      if (this->config_.mirror_touches)
+        this->touches.clear();
       return;
     }
 
-    if (duration < MAX_TAP_TIME) {
-      if (this->on_tap_)
-        this->on_tap_->trigger();
+    if (duration < this->config_.max_tap_time) {
+      // Taps and keys resolve where the finger lifted
+      int16_t x = this->hot_.last_point.x, y = this->hot_.last_point.y;
+
+      // A tap on the probe region is a measurement, not input
+      if (this->latency_probe_ && this->latency_probe_->contains(x, y)) {
+        SENTIO_STAGE(STAGE_TRIGGER);
+        uint32_t start = micros();
+        this->latency_probe_->send(millis());
+        this->record_trigger_time_(TRIGGER_PROBE, micros() - start);
+        return;
+      }
+
+      // A key press is that key's input, not a generic tap; on_key runs
+      // inside press()
+      for (auto *kb : this->keyboards_) {
+        if (!kb->contains(x, y))
+          continue;
+        SENTIO_STAGE(STAGE_TRIGGER);
+        uint32_t start = micros();
+        if (kb->press(x, y)) {
+          this->record_trigger_time_(TRIGGER_KEY, micros() - start);
+          return;
+        }
+      }
+
+      this->fire_(this->on_tap_, TRIGGER_TAP);
     }
   }
 }
 
-// Boilerplate to register triggers
-Trigger<> *SmartTouchComponent::get_trigger(const std::string &conf) {
-  if (conf == "on_swipe_left")
-    return this->on_swipe_left_;
-  if (conf == "on_swipe_right")
-    return this->on_swipe_right_;
-  if (conf == "on_tap")
-    return this->on_tap_;
-  if (conf == "on_wake")
-    return this->on_wake_;
-  if (conf == "on_sleep")
-    return this->on_sleep_;
-  return nullptr;
+void SENTIO_HOT SmartTouchComponent::mark_dirty_(int16_t x, int16_t y) {
+  int pad = this->config_.dirty_padding;
+  int max_x = this->config_.display_width - 1;
+  int max_y = this->config_.display_height - 1;
+  DirtyRect &d = this->dirty_;
+
+  d.x1 = std::min<int>(d.x1, std::max(0, x - pad));
+  d.y1 = std::min<int>(d.y1, std::max(0, y - pad));
+  d.x2 = std::max<int>(d.x2, std::min(max_x, x + pad));
+  d.y2 = std::max<int>(d.y2, std::min(max_y, y + pad));
+}
+
+#ifdef USE_SENTIO_BENCHMARK
+static const char *const BENCH_WORKLOAD_NAMES[NUM_BENCH_WORKLOADS] = {
+    "tap", "swipe", "multi"};
+static const char *const BENCH_STAGE_NAMES[NUM_STAGES] = {
+    "loop", "ingest", "calibrate", "filter", "recognize", "publish", "trigger"};
+
+void SmartTouchComponent::run_benchmark_(uint16_t iterations) {
+  // Scripted source for the duration; the configured one is never read
+  BenchSource bench;
+  touchscreen::Touchscreen *source = this->source_driver_;
+  this->source_driver_ = &bench;
+  ESP_LOGI("Sentio", "sentio-bench start iterations=%u", iterations);
+
+  for (uint8_t w = 0; w < NUM_BENCH_WORKLOADS; w++) {
+    this->stage_trace_.reset_cycles();
+    for (uint16_t i = 0; i < iterations; i++) {
+      uint8_t frame = 0;
+      bool down;
+      do {
+        down = bench.load_frame(static_cast<BenchWorkload>(w), frame++);
+        this->loop();
+        delay(BENCH_FRAME_MS);
+        App.feed_wdt(); // The whole run blocks the main loop for seconds
+      } while (down);
+    }
+
+    // Cycles per input frame, each stage inclusive of what it calls
+    uint32_t frames = this->stage_trace_.get_calls(STAGE_LOOP);
+    char line[192];
+    int n = snprintf(line, sizeof(line), "sentio-bench %s frames=%u",
+                     BENCH_WORKLOAD_NAMES[w], frames);
+    for (uint8_t s = 0; s < NUM_STAGES && n < int(sizeof(line)); s++) {
+      uint64_t cycles = this->stage_trace_.get_cycles(s);
+      n += snprintf(line + n, sizeof(line) - n, " %s=%u", BENCH_STAGE_NAMES[s],
+                    frames > 0 ? uint32_t(cycles / frames) : 0);
+    }
+    ESP_LOGI("Sentio", "%s", line);
+  }
+
+  ESP_LOGI("Sentio", "sentio-bench done");
+  this->source_driver_ = source;
+}
+#endif
+
+#ifdef USE_SENTIO_SOAK
+static const uint32_t SOAK_IDLE_MIN_MS = 1000;
+static const uint32_t SOAK_SLEEP_MARGIN_MS = 50;    // Run up to sleep for real
+static const int32_t SOAK_DRIFT_TOLERANCE_MS = 100; // A few loop() passes
+static const uint32_t SOAK_REPORT_INTERVAL = 10000; // Real ms
+static const int32_t SOAK_HEAP_SLACK = 4096;
+static const uint32_t SOAK_VIOLATIONS_LOGGED = 20;
+static const uint64_t MS_PER_DAY = 86400000ULL;
+
+static size_t soak_heap_used() {
+#if defined(USE_HOST)
+  return mallinfo2().uordblks;
+#elif defined(USE_ESP32)
+  return heap_caps_get_total_size(MALLOC_CAP_DEFAULT) -
+         heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+#else
+  return 0;
+#endif
+}
+
+void SmartTouchComponent::soak_step_() {
+  SoakState &s = this->soak_;
+  uint32_t now = millis();
+  uint64_t now64 = VirtualClock::now_ms();
+  if (s.start_ms == 0) {
+    s.start_ms = now64;
+    s.last_now = now;
+    s.activity_ms = now64;
+    s.last_activity = this->hot_.last_activity_time;
+    s.last_sleep_start = this->sleep_start_time_;
+    s.last_report = esphome::millis();
+    ESP_LOGI("Sentio", "sentio-soak start: %u days, idle up to %ums, "
+             "millis() wraps in %ums", s.days, s.max_idle_ms, ~now + 1);
+  }
+
+  // 1. CLOCK: wraps as the component sees them
+  if (now < s.last_now)
+    s.wraps++;
+  s.last_now = now;
+
+  // 2. SLEEP TIMING: the previous pass decided against this deadline. A
+  // touch can wake the panel in the same pass it fell asleep, so entries
+  // are read from the sleep stamp rather than hot_.is_sleeping.
+  if (this->sleep_start_time_ != s.last_sleep_start) {
+    s.last_sleep_start = this->sleep_start_time_;
+    s.asleep = true;
+    s.sleeps++;
+    uint64_t at = now64 - (now - this->sleep_start_time_);
+    int32_t drift = int32_t(int64_t(at - s.deadline_ms));
+    s.drift_min_ms = std::min(s.drift_min_ms, drift);
+    s.drift_max_ms = std::max(s.drift_max_ms, drift);
+    this->soak_check_(abs(drift) <= SOAK_DRIFT_TOLERANCE_MS,
+                      "sleep fired off its deadline");
+  }
+  if (s.asleep && !this->hot_.is_sleeping) {
+    s.asleep = false;
+    s.wakes++;
+  }
+  // Activity was stamped during the previous pass, so at most one pass ago
+  if (this->hot_.last_activity_time != s.last_activity) {
+    s.last_activity = this->hot_.last_activity_time;
+    s.activity_ms = now64;
+  }
+  if (!this->hot_.is_sleeping) {
+    s.deadline_ms = s.activity_ms + this->sleep_timeout_ms_;
+    this->soak_check_(now64 <= s.deadline_ms + SOAK_DRIFT_TOLERANCE_MS,
+                      "sleep deadline passed while awake");
+  }
+
+  // 3. INVARIANTS
+  uint16_t active = 0;
+  for (uint8_t i = 0; i < MAX_CONTACTS; i++) {
+    if (this->contacts_[i].active)
+      active |= 1 << i;
+  }
+  this->soak_check_(active == this->hot_.published_mask,
+                    "contact slots disagree with the published mask");
+  this->soak_check_(this->hot_.state != STATE_IDLE || this->release_deferred_ ||
+                        this->hot_.published_mask == 0,
+                    "contacts still published after release");
+  this->soak_check_(!this->hot_.is_sleeping || this->hot_.state == STATE_IDLE,
+                    "asleep mid-gesture");
+  this->soak_check_(int32_t(now - this->hot_.last_activity_time) >= 0,
+                    "last activity is in the future");
+  if (this->adaptive_sleep_ && s.sleeps > 0)
+    this->soak_check_(
+        this->sleep_timeout_ms_ >= this->min_sleep_timeout_ms_ &&
+            this->sleep_timeout_ms_ <= this->max_sleep_timeout_ms_,
+        "adaptive timeout out of range");
+
+  // 4. COUNTERS: only ever grow (a narrow one wrapping shows up here)
+  decltype(s.counters) counters = {
+      this->tracker_.get_reassignments(),
+      this->backpressure_events_,
+      this->coalesced_frames_,
+      this->wet_periods_,
+      this->prewakes_,
+      this->early_commits_,
+      this->early_retractions_,
+      this->trigger_overruns_,
+      this->sleep_model_.sleeps,
+      this->sleep_model_.quick_rewakes,
+  };
+  for (uint8_t i = 0; i < NUM_TRIGGERS; i++)
+    counters[SoakState::PLAIN_COUNTERS + i] = this->trigger_stats_[i].count;
+  for (size_t i = 0; i < counters.size(); i++)
+    this->soak_check_(counters[i] >= s.counters[i], "a counter went backwards");
+  s.counters = counters;
+
+  // 5. SKIP IDLE TIME: each stretch between touches lasts a log-uniform
+  // 1s..max_idle, but never jumps over the sleep check itself. Not before
+  // deferred init either: a restored timeout moves the deadline.
+  bool idle = this->source_driver_->touches.empty() &&
+              this->hot_.state == STATE_IDLE && !this->release_deferred_ &&
+              this->init_stage_ == INIT_DONE;
+  if (idle && !s.idle) {
+    float span = float(s.max_idle_ms) / SOAK_IDLE_MIN_MS;
+    s.idle_left_ms = SOAK_IDLE_MIN_MS * powf(span, random_float());
+  } else if (!idle && s.idle) {
+    s.touches++;
+  }
+  s.idle = idle;
+  if (idle && s.idle_left_ms > 0) {
+    uint64_t step = s.idle_left_ms;
+    // A stretch that would cross the wrap ends short of it instead, so the
+    // next touch's sleep deadline lands on the far side
+    uint32_t to_wrap = -now;
+    uint32_t lead = this->sleep_timeout_ms_ / 2;
+    if (step >= to_wrap && to_wrap > lead)
+      step = s.idle_left_ms = to_wrap - lead;
+    if (!this->hot_.is_sleeping) {
+      uint64_t land = s.deadline_ms - SOAK_SLEEP_MARGIN_MS;
+      step = std::min<uint64_t>(step, land > now64 ? land - now64 : 0);
+    }
+    VirtualClock::advance(step);
+    s.idle_left_ms -= step;
+  }
+
+  // 6. REPORT
+  bool done = now64 - s.start_ms >= s.days * MS_PER_DAY;
+  if (done || esphome::millis() - s.last_report >= SOAK_REPORT_INTERVAL) {
+    s.last_report = esphome::millis();
+    this->soak_report_(done);
+  }
+}
+
+void SmartTouchComponent::soak_check_(bool ok, const char *what) {
+  if (ok)
+    return;
+  SoakState &s = this->soak_;
+  if (s.violations++ < SOAK_VIOLATIONS_LOGGED)
+    ESP_LOGE("Sentio", "sentio-soak violation at day %.3f: %s",
+             (VirtualClock::now_ms() - s.start_ms) / float(MS_PER_DAY), what);
+}
+
+void SmartTouchComponent::soak_report_(bool done) {
+  SoakState &s = this->soak_;
+  // The first report sets the baseline: setup() and the first passes have
+  // made their allocations by then
+  size_t heap = soak_heap_used();
+  if (s.heap_base == 0)
+    s.heap_base = heap;
+  int32_t growth = int32_t(heap - s.heap_base);
+  s.heap_growth_max = std::max(s.heap_growth_max, growth);
+  this->soak_check_(growth <= SOAK_HEAP_SLACK, "heap keeps growing");
+
+  ESP_LOGI("Sentio",
+           "sentio-soak day %.2f: wraps=%u sleeps=%u wakes=%u touches=%u "
+           "drift=%d..%dms heap=%u (%+d) violations=%u",
+           (VirtualClock::now_ms() - s.start_ms) / float(MS_PER_DAY), s.wraps,
+           s.sleeps, s.wakes, s.touches, s.drift_min_ms, s.drift_max_ms,
+           unsigned(heap), growth, s.violations);
+  if (!done)
+    return;
+
+  ESP_LOGI("Sentio", "sentio-soak done: %s", s.violations ? "FAIL" : "PASS");
+  s.days = 0; // Back to plain operation (the clock stays where it is)
+#ifdef USE_HOST
+  exit(s.violations ? 1 : 0);
+#endif
 }
+#endif
 
 } // namespace sentio
 } // namespace esphome
@@ -1,7 +1,25 @@
 #pragma once
+#include <array>
+
 #include "esphome.h"
 #include "esphome/components/touchscreen/touchscreen.h"
 #include "esphome/core/automation.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/binary_sensor/binary_sensor.h"
+
+#include "Benchmark.h"
+#include "ContactTracker.h"
+#include "KeyboardRegion.h"
+#include "LatencyProbe.h"
+#include "Placement.h"
+#include "SharedContacts.h"
+#include "StageTrace.h"
+#include "TokenLog.h"
+#include "VirtualClock.h"
+
+#ifdef USE_SENTIO_TRACE_STREAM
+#include "TraceStream.h"
+#endif
 
 namespace esphome {
 namespace sentio {
@@ -14,6 +32,86 @@ enum TouchState {
   STATE_RELEASED  // Let go
 };
 
+// What it takes to wake a sleeping panel. Anything but WAKE_ANY keeps the
+// screen dark through screen cleaning, brushes and ghost touches.
+enum WakePolicy : uint8_t {
+  WAKE_ANY,        // First contact
+  WAKE_DOUBLE_TAP, // Two taps in quick succession, close together
+  WAKE_HOLD,       // One finger held still for the hold time
+  WAKE_SWIPE_UP,   // One finger moving up by the swipe threshold
+};
+
+// Screen area touched by input since a consumer last asked. Inclusive: pass
+// x2 + 1, y2 + 1 to APIs that take an exclusive right/bottom edge, such as
+// Display::start_clipping().
+struct DirtyRect {
+  int16_t x1{INT16_MAX}, y1{INT16_MAX};
+  int16_t x2{INT16_MIN}, y2{INT16_MIN};
+
+  bool is_empty() const { return x2 < x1 || y2 < y1; }
+  int16_t width() const { return is_empty() ? 0 : x2 - x1 + 1; }
+  int16_t height() const { return is_empty() ? 0 : y2 - y1 + 1; }
+};
+
+// Samples the early-commit predictor looks at (the first N of a touch)
+static const uint8_t EARLY_SWIPE_SAMPLES = 4;
+
+// Time-dependent coefficients for one band of source report rates
+struct RateProfile {
+  uint16_t max_hz;       // Band upper bound
+  uint8_t early_samples; // Early-commit window, ~35-50ms of input
+};
+
+// Work setup() leaves for idle loop slices, one stage per slice
+enum InitStage : uint8_t {
+  INIT_RESTORE_SLEEP_MODEL,
+  INIT_RESTORE_KEYBOARDS,
+  INIT_DONE,
+};
+
+// Log2 buckets for idle gaps between interactions (2s .. ~68min)
+static const uint8_t SLEEP_GAP_BUCKETS = 12;
+
+// Persisted adaptive sleep state (kept small: it lives in preferences)
+struct AdaptiveSleepModel {
+  uint8_t version;
+  uint32_t timeout_ms;
+  uint16_t gaps[SLEEP_GAP_BUCKETS]; // Aged histogram of idle gaps
+  uint16_t quick_rewakes;           // Wakes within the rewake window
+  uint16_t sleeps;
+};
+
+// Automations Sentio runs, for per-trigger timing
+enum TriggerId : uint8_t {
+  TRIGGER_SWIPE_LEFT,
+  TRIGGER_SWIPE_RIGHT,
+  TRIGGER_SWIPE_CANCEL,
+  TRIGGER_TAP,
+  TRIGGER_WAKE,
+  TRIGGER_SLEEP,
+  TRIGGER_KEY,   // Any keyboard's on_key
+  TRIGGER_PROBE, // latency_probe's on_probe
+  NUM_TRIGGERS,
+};
+
+// Execution time of one trigger's automation (synchronous, in loop())
+struct TriggerStats {
+  uint32_t count{0};
+  uint32_t max_us{0};
+  uint64_t total_us{0};
+  uint32_t over_budget{0};
+
+  uint32_t mean_us() const { return count > 0 ? total_us / count : 0; }
+};
+
+// One preallocated output slot, indexed by Sentio's stable contact ID.
+// Updated in place every frame and flagged active/inactive on press/release,
+// so publishing never touches the heap.
+struct Contact {
+  touchscreen::TouchPoint point{};
+  bool active{false};
+};
+
 class SmartTouchComponent : public touchscreen::Touchscreen, public Component {
 public:
   // --- Setup & Config ---
@@ -21,23 +119,173 @@ public:
     source_driver_ = source;
   }
   void set_resolution(int w, int h) {
-    display_width_ = w;
-    display_height_ = h;
+    config_.display_width = w;
+    config_.display_height = h;
   }
   void set_sleep_timeout(uint32_t t) { sleep_timeout_ms_ = t; }
-  void set_suppress_wake_click(bool b) { suppress_wake_click_ = b; }
+  void set_adaptive_sleep(uint32_t min_ms, uint32_t max_ms,
+                          uint32_t rewake_ms) {
+    adaptive_sleep_ = true;
+    min_sleep_timeout_ms_ = min_ms;
+    max_sleep_timeout_ms_ = max_ms;
+    rewake_window_ms_ = rewake_ms;
+  }
+  uint32_t get_sleep_timeout() const { return sleep_timeout_ms_; }
+  // Presence/PIR/proximity: turning on while asleep starts the wake early
+  void add_wake_sensor(binary_sensor::BinarySensor *s) {
+    s->add_on_state_callback([this](bool state) {
+      if (state)
+        this->prewake_pending_ = true;
+    });
+  }
+  void set_suppress_after_prewake(bool b) { suppress_after_prewake_ = b; }
+  void set_wake_policy(WakePolicy policy, uint32_t hold_ms) {
+    wake_policy_ = policy;
+    wake_hold_ms_ = hold_ms;
+  }
+  // Poll the source every interval_ms while asleep, doubling the interval
+  // every backoff_ms of sleep up to max_ms (no backoff if max_ms is lower)
+  void set_sleep_polling(uint32_t interval_ms, uint32_t max_ms,
+                         uint32_t backoff_ms) {
+    sleep_poll_ms_ = interval_ms;
+    sleep_poll_max_ms_ = max_ms;
+    sleep_poll_backoff_ms_ = backoff_ms;
+  }
+  void set_suppress_wake_click(bool b) { config_.suppress_wake_click = b; }
   void set_calibration(bool swap, bool inv_x, bool inv_y) {
-    swap_xy_ = swap;
-    invert_x_ = inv_x;
-    invert_y_ = inv_y;
+    config_.swap_xy = swap;
+    config_.invert_x = inv_x;
+    config_.invert_y = inv_y;
+  }
+  void set_debounce_threshold(uint32_t ms) { config_.debounce_ms = ms; }
+  void set_swipe_threshold(int px) { config_.swipe_threshold = px; }
+  void set_max_tap_time(uint32_t ms) { config_.max_tap_time = ms; }
+  void set_report_rate_sensor(sensor::Sensor *s) { report_rate_sensor_ = s; }
+  void set_report_jitter_sensor(sensor::Sensor *s) {
+    report_jitter_sensor_ = s;
+  }
+  void set_boot_to_ready_sensor(sensor::Sensor *s) {
+    boot_to_ready_sensor_ = s;
+  }
+  void set_backpressure_events_sensor(sensor::Sensor *s) {
+    backpressure_events_sensor_ = s;
+  }
+  void set_backpressure_time_sensor(sensor::Sensor *s) {
+    backpressure_time_sensor_ = s;
+  }
+  void set_trigger_time_max_sensor(sensor::Sensor *s) {
+    trigger_time_max_sensor_ = s;
+  }
+  void set_wakes_prevented_sensor(sensor::Sensor *s) {
+    wakes_prevented_sensor_ = s;
+  }
+  void set_wake_poll_latency_sensor(sensor::Sensor *s) {
+    wake_poll_latency_sensor_ = s;
+  }
+  void set_sleep_poll_duty_sensor(sensor::Sensor *s) {
+    sleep_poll_duty_sensor_ = s;
+  }
+  // Automations running longer than this log a (rate-limited) warning
+  void set_trigger_budget(uint32_t us) { trigger_budget_us_ = us; }
+  void set_debug_raw(bool b) { config_.debug_raw = b; }
+  void set_water_rejection(uint8_t min_contacts, uint32_t clear_ms) {
+    water_rejection_ = true;
+    water_min_contacts_ = min_contacts;
+    water_clear_ms_ = clear_ms;
+  }
+  void set_wet_sensor(binary_sensor::BinarySensor *s) { wet_sensor_ = s; }
+  void set_mirror_touches(bool b) { config_.mirror_touches = b; }
+  void set_dirty_padding(uint16_t px) { config_.dirty_padding = px; }
+  void add_keyboard(KeyboardRegion *kb) { keyboards_.push_back(kb); }
+  void set_latency_probe(LatencyProbe *p) { latency_probe_ = p; }
+#ifdef USE_SENTIO_TRACE_STREAM
+  void set_trace_stream(uart::UARTComponent *uart) { trace_.set_uart(uart); }
+  const TraceStream &get_trace_stream() const { return trace_; }
+#endif
+#ifdef USE_SENTIO_STAGE_TRACE
+  void set_stage_trace(size_t events) { stage_trace_events_ = events; }
+  // Log the recorded stage events (tools/sentio_perfetto.py makes a timeline)
+  void dump_stage_trace() const { stage_trace_.dump(); }
+#endif
+#ifdef USE_SENTIO_BENCHMARK
+  // Benchmark firmware: run the scripted workloads on the first loop()
+  void set_benchmark(uint16_t iterations) { bench_iterations_ = iterations; }
+#endif
+#ifdef USE_SENTIO_SOAK
+  // Soak firmware: run `days` of virtual time, idle stretches up to max_idle
+  void set_soak(uint32_t days, uint32_t max_idle_ms) {
+    soak_.days = days;
+    soak_.max_idle_ms = max_idle_ms;
+  }
+#endif
+  void set_early_swipe(bool enabled, float velocity, float confidence) {
+    config_.early_swipe = enabled;
+    config_.early_swipe_velocity = velocity;
+    config_.early_swipe_confidence = confidence;
   }
-  void set_debounce_threshold(uint32_t ms) { debounce_ms_ = ms; }
-  void set_debug_raw(bool b) { debug_raw_ = b; }
+
+  // --- Output (read these from lambdas instead of `touches`) ---
+  const std::array<Contact, MAX_CONTACTS> &contacts() const {
+    note_consumer_read_();
+    return contacts_;
+  }
+  // Area to redraw since the last call (old and new contact positions,
+  // padded), then reset. Call once per display frame.
+  DirtyRect take_dirty_rect() {
+    note_consumer_read_();
+    DirtyRect r = dirty_;
+    dirty_ = DirtyRect{};
+    return r;
+  }
+  const DirtyRect &peek_dirty_rect() const { return dirty_; }
+  // For lambdas that only peek_dirty_rect(), so their pace is still tracked
+  void notify_consumer_read() { note_consumer_read_(); }
+#ifdef USE_SENTIO_SHARED_CONTACTS
+  // Safe from any task (a render task on the other core): a consistent copy
+  // of the slots above. The others belong to loop()'s task. Returns the
+  // publish count; the same value as last time means nothing moved.
+  uint32_t read_contacts(std::array<Contact, MAX_CONTACTS> &out) const;
+  const SharedContacts &get_shared_contacts() const { return shared_; }
+#endif
+
+  // --- Diagnostics ---
+  float get_report_rate() const {
+    return hot_.frame_interval_us > 0 ? 1e6f / hot_.frame_interval_us : 0.0f;
+  }
+  float get_report_jitter_ms() const { return hot_.frame_jitter_us / 1000.0f; }
+  uint32_t get_id_reassignments() const {
+    return tracker_.get_reassignments();
+  }
+  uint32_t get_boot_to_ready_ms() const { return boot_to_ready_ms_; }
+  // Since the current (or just released) touch landed; for gesture triggers
+  uint32_t get_gesture_duration() const {
+    return millis() - hot_.gesture_start_time;
+  }
+  bool is_wet() const { return wet_; }
+  uint32_t get_wet_periods() const { return wet_periods_; }
+  uint32_t get_wet_ms_total() const { return wet_ms_total_; }
+  bool is_backpressured() const { return backpressure_; }
+  uint32_t get_backpressure_events() const { return backpressure_events_; }
+  uint32_t get_coalesced_frames() const { return coalesced_frames_; }
+  // Touches while asleep that didn't make the wake gesture
+  uint32_t get_wakes_prevented() const { return wakes_prevented_; }
+  // Sleep polling: interval in effect when the last contact was found (the
+  // most it can have added to that wake), and polls made while asleep as a
+  // percentage of what full rate would have made
+  uint32_t get_wake_poll_latency_ms() const { return wake_poll_latency_ms_; }
+  float get_sleep_poll_duty() const {
+    return polls_full_ > 0 ? 100.0f * polls_slow_ / polls_full_ : 100.0f;
+  }
+  const TriggerStats &get_trigger_stats(TriggerId id) const {
+    return trigger_stats_[id];
+  }
+  // Count, mean and max of every trigger that has run, to the log
+  void log_trigger_stats() const;
 
   // --- Triggers (Automation hooks) ---
-  Trigger<> *get_trigger(const std::string &conf);
   void set_on_swipe_left(Trigger<> *t) { on_swipe_left_ = t; }
   void set_on_swipe_right(Trigger<> *t) { on_swipe_right_ = t; }
+  void set_on_swipe_cancel(Trigger<> *t) { on_swipe_cancel_ = t; }
   void set_on_tap(Trigger<> *t) { on_tap_ = t; }
   void set_on_wake(Trigger<> *t) { on_wake_ = t; }
   void set_on_sleep(Trigger<> *t) { on_sleep_ = t; }
@@ -47,36 +295,269 @@ public:
   void loop() override;
 
 protected:
+  // Set from YAML before setup(), read-only afterwards
+  struct Config {
+    int display_width{0}, display_height{0};
+    bool suppress_wake_click{false};
+    bool swap_xy{false}, invert_x{false}, invert_y{false};
+    bool debug_raw{false};
+    bool mirror_touches{true};
+    uint32_t debounce_ms{0};
+    int swipe_threshold{30};    // Pixels to trigger a swipe
+    uint32_t max_tap_time{400}; // Max ms for a tap (otherwise it's a hold)
+    bool early_swipe{false};
+    float early_swipe_velocity{0.3f}; // px/ms where the speed score is 1.0
+    float early_swipe_confidence{0.8f};
+    uint16_t dirty_padding{8};
+  };
+
+  // One of the first samples of a touch (early-commit input)
+  struct Sample {
+    int16_t x, y;
+    uint32_t t;
+  };
+
+  // Everything a frame reads and writes, in one block apart from config and
+  // the diagnostics, so a frame touches a few adjacent cache lines
+  struct FrameState {
+    // Input Frame (calibrated, stable IDs)
+    std::array<touchscreen::TouchPoint, MAX_CONTACTS> frame{};
+    std::array<uint8_t, MAX_CONTACTS> frame_ids{};
+    uint16_t published_mask{0}; // Output slots in use, bit per slot
+
+    // Runtime State
+    uint32_t last_activity_time{0};
+    bool is_sleeping{false};
+    bool ignore_next_release{false}; // The Trap Flag
+
+    // Gesture State
+    TouchState state{STATE_IDLE};
+    uint32_t gesture_start_time{0};
+    int16_t start_x{0}, start_y{0};
+    uint8_t primary_id{0};                // Finger the gestures follow
+    touchscreen::TouchPoint last_point{}; // Its last calibrated sample
+
+    // Early-Commit State (first samples of the current touch)
+    std::array<Sample, EARLY_SWIPE_SAMPLES> samples{};
+    uint8_t sample_count{0};
+    bool early_committed{false};   // Swipe fired, threshold not yet crossed
+    bool gesture_cancelled{false}; // Retracted; no tap for this touch
+    int8_t early_dir{0};
+    uint32_t early_commit_time{0};
+
+    // Report Rate (EWMA over frame intervals while a finger is down)
+    uint32_t last_frame_us{0};
+    int16_t last_raw_x{0}, last_raw_y{0};
+    int32_t frame_interval_us{0};
+    int32_t frame_jitter_us{0};
+    const RateProfile *rate_profile{nullptr};
+  };
+
   // Internal Logic
   touchscreen::Touchscreen *source_driver_{nullptr};
 
   // Config Variables
-  int display_width_, display_height_;
-  uint32_t sleep_timeout_ms_;
-  bool suppress_wake_click_, swap_xy_, invert_x_, invert_y_, debug_raw_;
-  uint32_t debounce_ms_;
+  Config config_;
+  uint32_t sleep_timeout_ms_; // Adaptive sleep moves it
+
+  // Per-Frame State
+  FrameState hot_;
+
+  // Regions
+  std::vector<KeyboardRegion *> keyboards_;
+  LatencyProbe *latency_probe_{nullptr};
+
+  // Contact IDs
+  ContactTracker tracker_;
+
+  // Output Slots
+  std::array<Contact, MAX_CONTACTS> contacts_{};
+  DirtyRect dirty_{};
+#ifdef USE_SENTIO_SHARED_CONTACTS
+  SharedContacts shared_;
+  uint32_t shared_reads_seen_{0}; // Folded into consumer_reads_ by loop()
+  void share_contacts_();
+#endif
+
+  // Consumer Backpressure, for the lambda view only (slots, dirty rect,
+  // shared copy); the LVGL mirror is never held back. Reads are counted from
+  // the (const) accessors, so these are mutable; edges are held until a read
+  // has seen the previous one
+  mutable uint32_t consumer_reads_{0};
+  mutable uint32_t frames_since_read_{0}; // Input frames since the last read
+  mutable uint32_t last_read_ms_{0};
+  mutable uint32_t read_interval_ms_{0}; // The reader's usual pace
+  mutable uint8_t steady_reads_{0};      // Consecutive reads at that pace
+  bool backpressure_{false};
+  bool release_deferred_{false};
+  uint32_t reads_at_publish_{0}, reads_at_edge_{0};
+  uint32_t edge_time_{0};
+  uint32_t backpressure_start_{0};
+  uint32_t backpressure_events_{0};
+  uint32_t backpressure_ms_total_{0};
+  uint32_t coalesced_frames_{0};
+
+#ifdef USE_SENTIO_TRACE_STREAM
+  TraceStream trace_;
+#endif
+#ifdef USE_SENTIO_STAGE_TRACE
+  StageTrace stage_trace_;
+  size_t stage_trace_events_{512};
+#endif
+#ifdef USE_SENTIO_BENCHMARK
+  uint16_t bench_iterations_{0};
+  void run_benchmark_(uint16_t iterations);
+#endif
+#ifdef USE_SENTIO_SOAK
+  // Checked once per loop() against a 64-bit clock that never wraps
+  struct SoakState {
+    uint32_t days{0}; // 0: not soaking (or finished)
+    uint32_t max_idle_ms{0};
+    uint64_t start_ms{0};
+    uint64_t activity_ms{0};  // Last activity, virtual time
+    uint64_t deadline_ms{0};  // When sleep is due
+    uint64_t idle_left_ms{0}; // Rest of the current idle stretch
+    uint32_t last_now{0}, last_activity{0}, last_sleep_start{0};
+    bool idle{false}, asleep{false};
+    uint32_t wraps{0}, sleeps{0}, wakes{0}, touches{0};
+    int32_t drift_min_ms{0}, drift_max_ms{0};
+    static const uint8_t PLAIN_COUNTERS = 10; // Then one per trigger
+    std::array<uint32_t, PLAIN_COUNTERS + NUM_TRIGGERS> counters{};
+    size_t heap_base{0};
+    int32_t heap_growth_max{0};
+    uint32_t violations{0};
+    uint32_t last_report{0}; // Real time
+  } soak_;
+  void soak_step_();
+  void soak_check_(bool ok, const char *what);
+  void soak_report_(bool done);
+#endif
+
+  // Startup
+  uint32_t boot_to_ready_ms_{0}; // 0 until the first loop() accepts input
+  InitStage init_stage_{INIT_RESTORE_SLEEP_MODEL};
+
+  // Water Rejection
+  bool water_rejection_{false};
+  uint8_t water_min_contacts_{3};
+  uint32_t water_clear_ms_{2000};
+  bool multi_touch_{false}; // 2+ contacts since multi_start_
+  uint32_t multi_start_{0};
+  int16_t multi_x_{0}, multi_y_{0};
+  bool wet_evidence_{false};
+  uint32_t wet_evidence_start_{0};
+  bool wet_{false};
+  uint32_t wet_start_{0}, wet_last_seen_{0};
+  uint32_t wet_periods_{0};
+  uint32_t wet_ms_total_{0};
+
+  // Pre-Wake (presence sensors)
+  bool prewake_pending_{false};
+  bool prewoken_{false}; // Awake from presence, no touch yet
+  bool suppress_after_prewake_{false};
+  uint32_t prewakes_{0};
+
+  // Wake Gesture (any policy but WAKE_ANY, recognised while asleep)
+  struct WakeGesture {
+    bool down{false};  // Contact since the last lift
+    bool stray{false}; // Moved, or more than one finger: no tap or hold
+    uint32_t down_time{0};
+    int16_t x{0}, y{0}; // Where it landed (calibrated)
+    bool tap_pending{false}; // Double tap: the first one is in
+    uint32_t tap_time{0};
+    int16_t tap_x{0}, tap_y{0};
+  };
+  WakePolicy wake_policy_{WAKE_ANY};
+  uint32_t wake_hold_ms_{600};
+  WakeGesture wake_gesture_{};
+  uint32_t wakes_prevented_{0};
+
+  // Sleep Polling (sources without an interrupt pin)
+  uint32_t sleep_poll_ms_{0}; // 0: the source keeps its own interval
+  uint32_t sleep_poll_max_ms_{0};
+  uint32_t sleep_poll_backoff_ms_{60000};
+  uint32_t source_poll_ms_{0};   // The source's own interval
+  uint32_t poll_interval_ms_{0}; // In effect now; 0 while at full rate
+  uint32_t poll_since_{0};       // Start of the unaccounted stretch
+  float polls_slow_{0}, polls_full_{0}; // Estimated, while asleep
+  uint32_t wake_poll_latency_ms_{0};
+
+  // Diagnostics
+  uint32_t last_diagnostics_time_{0};
+  sensor::Sensor *report_rate_sensor_{nullptr};
+  sensor::Sensor *report_jitter_sensor_{nullptr};
+  sensor::Sensor *boot_to_ready_sensor_{nullptr};
+  binary_sensor::BinarySensor *wet_sensor_{nullptr};
+  sensor::Sensor *backpressure_events_sensor_{nullptr};
+  sensor::Sensor *backpressure_time_sensor_{nullptr};
+  sensor::Sensor *trigger_time_max_sensor_{nullptr};
+  sensor::Sensor *wakes_prevented_sensor_{nullptr};
+  sensor::Sensor *wake_poll_latency_sensor_{nullptr};
+  sensor::Sensor *sleep_poll_duty_sensor_{nullptr};
+
+  // Trigger Profiling
+  std::array<TriggerStats, NUM_TRIGGERS> trigger_stats_{};
+  uint32_t trigger_budget_us_{10000};
+  uint32_t trigger_overruns_{0};
+  uint32_t trigger_overruns_logged_{0};
+  uint32_t last_trigger_warning_{0};
 
-  // Runtime State
-  uint32_t last_activity_time_{0};
-  bool is_sleeping_{false};
-  bool ignore_next_release_{false}; // The Trap Flag
+  // Adaptive Sleep
+  bool adaptive_sleep_{false};
+  uint32_t min_sleep_timeout_ms_{0}, max_sleep_timeout_ms_{0};
+  uint32_t rewake_window_ms_{0};
+  uint32_t sleep_start_time_{0};
+  bool pending_quick_rewake_{false};
+  uint16_t pending_gaps_[SLEEP_GAP_BUCKETS]{}; // Since the last sleep event
+  AdaptiveSleepModel sleep_model_{};
+  ESPPreferenceObject sleep_pref_;
 
-  // Gesture State
-  TouchState state_{STATE_IDLE};
-  uint32_t gesture_start_time_{0};
-  int16_t start_x_{0}, start_y_{0};
+  // Early-Commit Statistics
+  uint32_t early_commits_{0};
+  uint32_t early_retractions_{0};
+  uint32_t early_lead_ms_total_{0}; // Latency won over the threshold path
 
   // Triggers
   Trigger<> *on_swipe_left_{nullptr};
   Trigger<> *on_swipe_right_{nullptr};
+  Trigger<> *on_swipe_cancel_{nullptr};
   Trigger<> *on_tap_{nullptr};
   Trigger<> *on_wake_{nullptr};
   Trigger<> *on_sleep_{nullptr};
 
   // Helpers
+  bool check_water_(size_t count, const touchscreen::TouchPoint &raw);
+  void start_wet_period_();
+  void end_wet_period_();
+  void wake_();
+  bool check_wake_gesture_(const touchscreen::TouchPoint *raw, size_t count);
+  void reject_wake_();
+  void set_sleep_polling_(bool slow);
+  void account_polls_(uint32_t now);
   touchscreen::TouchPoint apply_calibration(touchscreen::TouchPoint p);
   void process_gestures(touchscreen::TouchPoint p);
   void handle_release();
+  void push_sample_(const touchscreen::TouchPoint &p, uint32_t now);
+  int8_t predict_swipe_();
+  void fire_(Trigger<> *trigger, TriggerId id);
+  void record_trigger_time_(TriggerId id, uint32_t us);
+  void fire_swipe_(int8_t dir);
+  void retract_swipe_();
+  void run_deferred_init_();
+  void track_report_rate_(const touchscreen::TouchPoint &raw);
+  void select_rate_profile_();
+  void publish_diagnostics_();
+  void record_interaction_gap_(uint32_t gap_ms);
+  void update_sleep_model_();
+  void restore_sleep_model_();
+  void output_frame_(uint8_t count);
+  void output_release_();
+  void update_backpressure_();
+  void note_consumer_read_() const;
+  void publish_frame_(uint8_t count);
+  void mirror_frame_(uint8_t count, uint16_t mask);
+  void release_contacts_();
+  void mark_dirty_(int16_t x, int16_t y);
 };
 
 } // namespace sentio
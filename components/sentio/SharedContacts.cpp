@@ -0,0 +1,64 @@
+#include "SharedContacts.h"
+
+#ifdef USE_SENTIO_SHARED_CONTACTS
+#include "esphome/core/hal.h"
+
+namespace esphome {
+namespace sentio {
+
+// Spins before a reader sleeps: a higher-priority reader on the writer's
+// core would otherwise never let the publish finish
+static const uint8_t READ_SPINS = 8;
+
+void SharedContacts::begin_write() {
+  this->seq_.store(this->seq_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  // Readers that see any store after this also see the odd sequence
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedContacts::end_write(uint16_t active) {
+  this->active_.store(active, std::memory_order_relaxed);
+  this->seq_.store(this->seq_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+}
+
+uint32_t SharedContacts::read(touchscreen::TouchPoint *points,
+                              uint16_t &active) const {
+  uint32_t before;
+  for (uint8_t attempt = 1;; attempt++) {
+    if (attempt > READ_SPINS) {
+      delay(1);
+      attempt = 1;
+    }
+    before = this->seq_.load(std::memory_order_acquire);
+    if (before & 1) {
+      this->retries_.fetch_add(1, std::memory_order_relaxed);
+      continue; // Publish in progress (a handful of stores)
+    }
+
+    active = this->active_.load(std::memory_order_relaxed);
+    for (uint8_t i = 0; i < MAX_CONTACTS; i++) {
+      uint32_t xy = this->xy_[i].load(std::memory_order_relaxed);
+      uint32_t id_p = this->id_p_[i].load(std::memory_order_relaxed);
+      points[i] = touchscreen::TouchPoint{};
+      points[i].id = id_p & 0xFF;
+      points[i].pressure = int16_t(id_p >> 8);
+      points[i].x = int16_t(xy & 0xFFFF);
+      points[i].y = int16_t(xy >> 16);
+    }
+
+    // The copy is good if no publish started while it was taken
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (this->seq_.load(std::memory_order_relaxed) == before)
+      break;
+    this->retries_.fetch_add(1, std::memory_order_relaxed);
+  }
+  this->reads_.fetch_add(1, std::memory_order_relaxed);
+  return before / 2;
+}
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_SHARED_CONTACTS
@@ -0,0 +1,54 @@
+#pragma once
+#include "esphome/core/defines.h"
+
+#ifdef USE_SENTIO_SHARED_CONTACTS
+#include <atomic>
+#include <cstdint>
+
+#include "esphome/components/touchscreen/touchscreen.h"
+
+#include "ContactTracker.h"
+
+namespace esphome {
+namespace sentio {
+
+// Copy of the output slots that another task (a render task on the other
+// core, say) can read while loop() publishes. A sequence lock: the writer
+// never waits, readers retry if a publish overlapped their copy. Every field
+// is an atomic word, so there is no data race even while the copy is torn.
+// Carries id, x, y and pressure; the rest of TouchPoint reads as zero.
+class SharedContacts {
+public:
+  // loop() only: begin_write(), store() each active slot, end_write()
+  void begin_write();
+  void store(uint8_t slot, const touchscreen::TouchPoint &p) {
+    this->xy_[slot].store(uint16_t(p.x) | uint32_t(uint16_t(p.y)) << 16,
+                          std::memory_order_relaxed);
+    this->id_p_[slot].store(p.id | uint32_t(uint16_t(p.pressure)) << 8,
+                            std::memory_order_relaxed);
+  }
+  void end_write(uint16_t active);
+
+  // Any task. Fills points[MAX_CONTACTS] and the active mask; returns the
+  // publish count, so a reader can skip work when nothing changed.
+  uint32_t read(touchscreen::TouchPoint *points, uint16_t &active) const;
+
+  // Completed reads and retries, from all readers
+  uint32_t get_reads() const { return reads_.load(std::memory_order_relaxed); }
+  uint32_t get_retries() const {
+    return retries_.load(std::memory_order_relaxed);
+  }
+
+protected:
+  std::atomic<uint32_t> seq_{0}; // Odd while a publish is in progress
+  std::atomic<uint32_t> active_{0};
+  std::atomic<uint32_t> xy_[MAX_CONTACTS]{};   // x low half, y high half
+  std::atomic<uint32_t> id_p_[MAX_CONTACTS]{}; // id low byte, pressure above
+  mutable std::atomic<uint32_t> reads_{0};
+  mutable std::atomic<uint32_t> retries_{0};
+};
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_SHARED_CONTACTS
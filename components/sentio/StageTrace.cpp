@@ -0,0 +1,49 @@
+#include "StageTrace.h"
+
+#ifdef USE_SENTIO_STAGE_TRACE
+#include <algorithm>
+#include <cstdio>
+
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sentio {
+
+static const size_t DUMP_EVENTS_PER_LINE = 32; // 320 hex chars per log line
+
+void StageTrace::init(size_t events) {
+  // Written several times per frame while armed: internal RAM whatever the
+  // size, so recording doesn't wait on PSRAM writes or perturb the timings
+  this->events_ = place_buffer<Event>(events, PLACEMENT_INTERNAL);
+  this->capacity_ = events;
+  this->head_ = 0;
+}
+
+void StageTrace::dump() const {
+  if (this->events_ == nullptr)
+    return;
+
+  // Oldest first. The ring may start mid-scope; the exporter drops unmatched
+  // end events.
+  uint32_t count = std::min<uint32_t>(this->head_, this->capacity_);
+  uint32_t first = this->head_ - count;
+  ESP_LOGI("Sentio", "stage-trace: %u events (%u overwritten), now=%u", count,
+           this->head_ - count, micros());
+
+  char line[DUMP_EVENTS_PER_LINE * 10 + 1];
+  uint32_t chunk = 0;
+  for (uint32_t i = 0; i < count; i += DUMP_EVENTS_PER_LINE, chunk++) {
+    char *out = line;
+    uint32_t end = std::min<uint32_t>(count, i + DUMP_EVENTS_PER_LINE);
+    for (uint32_t j = i; j < end; j++) {
+      const Event &e = this->events_[(first + j) % this->capacity_];
+      out += sprintf(out, "%08x%02x", e.t, e.tag);
+    }
+    ESP_LOGI("Sentio", "stage-trace[%u]: %s", chunk, line);
+  }
+}
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_STAGE_TRACE
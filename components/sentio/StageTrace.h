@@ -0,0 +1,126 @@
+#pragma once
+#include "esphome/core/defines.h"
+
+#ifdef USE_SENTIO_STAGE_TRACE
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+#include "Placement.h"
+
+namespace esphome {
+namespace sentio {
+
+// Pipeline stages as they appear on the exported timeline. Keep the order in
+// sync with STAGE_NAMES in tools/sentio_perfetto.py.
+enum Stage : uint8_t {
+  STAGE_LOOP,      // One loop() pass with a finger involved
+  STAGE_INGEST,    // Reading the source, rate tracking, raw capture
+  STAGE_CALIBRATE, // Swap/invert/clamp of every contact
+  STAGE_FILTER,    // Water rejection and stable-ID tracking
+  STAGE_RECOGNIZE, // Gesture state machine, tap and key resolution
+  STAGE_PUBLISH,   // Output slots, mirrored touches, dirty rect
+  STAGE_TRIGGER,   // Automation dispatch (on_tap, on_swipe_*, ...)
+  NUM_STAGES,
+  STAGE_ARMED = NUM_STAGES, // Marker: recording resumed after idle time
+};
+
+static const uint8_t STAGE_END = 0x80; // Flag on the closing event
+
+// Begin/end events for the pipeline stages, kept in a ring that always holds
+// the most recent ones. Nothing is formatted on the hot path: dump() writes
+// the ring as hex log lines that tools/sentio_perfetto.py turns into
+// Chrome/Perfetto JSON (device logs and host replays alike).
+class StageTrace {
+public:
+  // Allocates the ring; events recorded before this are ignored
+  void init(size_t events);
+  // Only record while armed, so the ring holds whole gestures, not idle loops
+  void set_armed(bool armed) {
+    armed = armed && events_ != nullptr;
+    if (armed && !armed_) {
+      armed_ = true;
+      record(STAGE_ARMED, false);
+    }
+    armed_ = armed;
+  }
+
+  void record(uint8_t stage, bool end) {
+    if (!armed_)
+      return;
+#ifdef USE_SENTIO_BENCHMARK
+    // CPU cycles per stage (inclusive of nested stages); no stage nests in
+    // itself, so one start slot each is enough
+    if (stage < NUM_STAGES) {
+      uint32_t now = arch_get_cpu_cycle_count();
+      if (end) {
+        cycles_[stage] += now - cycle_start_[stage];
+        calls_[stage]++;
+      } else {
+        cycle_start_[stage] = now;
+      }
+    }
+#endif
+    Event &e = events_[head_++ % capacity_];
+    e.t = micros();
+    e.tag = end ? stage | STAGE_END : stage;
+  }
+
+  void dump() const;
+  void log_placement() const {
+    sentio::log_placement("Stage trace", events_, capacity_ * sizeof(Event));
+  }
+
+#ifdef USE_SENTIO_BENCHMARK
+  uint64_t get_cycles(uint8_t stage) const { return cycles_[stage]; }
+  uint32_t get_calls(uint8_t stage) const { return calls_[stage]; }
+  void reset_cycles() {
+    cycles_ = {};
+    calls_ = {};
+  }
+#endif
+
+protected:
+  struct __attribute__((packed)) Event {
+    uint32_t t; // micros()
+    uint8_t tag;
+  };
+
+  Event *events_{nullptr};
+  size_t capacity_{0};
+  uint32_t head_{0}; // Free-running
+  bool armed_{false};
+
+#ifdef USE_SENTIO_BENCHMARK
+  std::array<uint32_t, NUM_STAGES> cycle_start_{};
+  std::array<uint64_t, NUM_STAGES> cycles_{};
+  std::array<uint32_t, NUM_STAGES> calls_{};
+#endif
+};
+
+// Begin on construction, end when the scope closes
+class StageScope {
+public:
+  StageScope(StageTrace &trace, uint8_t stage) : trace_(trace), stage_(stage) {
+    trace_.record(stage_, false);
+  }
+  ~StageScope() { trace_.record(stage_, true); }
+
+protected:
+  StageTrace &trace_;
+  uint8_t stage_;
+};
+
+} // namespace sentio
+} // namespace esphome
+
+#define SENTIO_STAGE_CAT_(a, b) a##b
+#define SENTIO_STAGE_VAR_(line) SENTIO_STAGE_CAT_(sentio_stage_, line)
+#define SENTIO_STAGE(stage)                                                    \
+  ::esphome::sentio::StageScope SENTIO_STAGE_VAR_(__LINE__)(                   \
+      this->stage_trace_, stage)
+#else
+#define SENTIO_STAGE(stage)
+#endif // USE_SENTIO_STAGE_TRACE
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+#include "esphome/core/defines.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sentio {
+
+// 32-bit FNV-1a of a format string, evaluated at compile time. The same hash
+// runs in touchscreen.py to build the token database (sentio_tokens.json in
+// the build directory) that tools/sentio_trace.py uses to detokenize.
+constexpr uint32_t tokenize(const char *fmt) {
+  uint32_t hash = 2166136261u;
+  while (*fmt != '\0') {
+    hash ^= uint8_t(*fmt++);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+} // namespace sentio
+} // namespace esphome
+
+// Hot-path log line. With the trace stream compiled in, only the token and
+// the integer arguments go out, as a binary record; the format string never
+// reaches flash. Otherwise it is an ordinary ESP_LOGD.
+// Use one plain string literal: the build-time scanner doesn't join literals.
+#ifdef USE_SENTIO_TRACE_STREAM
+#define SENTIO_TLOG(fmt, ...)                                                  \
+  do {                                                                         \
+    static constexpr uint32_t sentio_token = ::esphome::sentio::tokenize(fmt); \
+    this->trace_.record_log(sentio_token, ##__VA_ARGS__);                      \
+  } while (0)
+#else
+#define SENTIO_TLOG(fmt, ...) ESP_LOGD("Sentio", fmt, ##__VA_ARGS__)
+#endif
@@ -0,0 +1,169 @@
+#include "TraceStream.h"
+
+#ifdef USE_SENTIO_TRACE_STREAM
+
+namespace esphome {
+namespace sentio {
+
+static const uint32_t UART_FIFO_SIZE = 128; // Writes up to this never block
+static const uint32_t DROP_LOG_INTERVAL = 5000;
+
+static uint8_t crc8(const uint8_t *data, size_t len) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+static uint8_t put_varint(uint8_t *out, uint32_t v) {
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = uint8_t(v) | 0x80;
+    v >>= 7;
+  }
+  out[n++] = uint8_t(v);
+  return n;
+}
+
+static uint8_t put_zigzag(uint8_t *out, int32_t v) {
+  return put_varint(out, (uint32_t(v) << 1) ^ uint32_t(v >> 31));
+}
+
+void TraceStream::record_sample(TraceRecord type, uint32_t t, uint8_t id,
+                                int16_t x, int16_t y) {
+  Encoder &e = type == TRACE_RAW ? this->raw_ : this->processed_;
+  uint8_t payload[TRACE_MAX_FRAME];
+  uint8_t n = 0;
+
+  if (e.absolute) {
+    payload[n++] = type | TRACE_ABSOLUTE;
+    payload[n++] = id;
+    n += put_varint(payload + n, t);
+    n += put_zigzag(payload + n, x);
+    n += put_zigzag(payload + n, y);
+  } else {
+    payload[n++] = type;
+    payload[n++] = id;
+    n += put_varint(payload + n, t - e.t);
+    n += put_zigzag(payload + n, x - e.x);
+    n += put_zigzag(payload + n, y - e.y);
+  }
+
+  if (!this->push_frame_(payload, n))
+    return;
+  e = {t, x, y, false};
+}
+
+void TraceStream::record_release(uint32_t t) {
+  uint8_t payload[8];
+  uint8_t n = 0;
+  if (this->release_absolute_) {
+    payload[n++] = TRACE_RELEASE | TRACE_ABSOLUTE;
+    n += put_varint(payload + n, t);
+  } else {
+    payload[n++] = TRACE_RELEASE;
+    n += put_varint(payload + n, t - this->last_release_t_);
+  }
+
+  if (!this->push_frame_(payload, n))
+    return;
+  this->last_release_t_ = t;
+  this->release_absolute_ = false;
+}
+
+void TraceStream::record_log_(uint32_t token, const int32_t *args,
+                              size_t count) {
+  uint8_t payload[TRACE_MAX_FRAME];
+  uint8_t n = 0;
+  payload[n++] = TRACE_LOG;
+  for (uint8_t i = 0; i < 4; i++)
+    payload[n++] = uint8_t(token >> (8 * i)); // Little endian
+  count = std::min<size_t>(count, TRACE_MAX_LOG_ARGS);
+  for (size_t i = 0; i < count; i++)
+    n += put_zigzag(payload + n, args[i]);
+  this->push_frame_(payload, n);
+}
+
+bool TraceStream::push_frame_(const uint8_t *payload, uint8_t len) {
+  size_t used = this->head_ - this->tail_;
+  size_t frame_len = len + 3;
+
+  // Report earlier losses first, so the host knows where the gap is
+  if (this->dropped_ > 0) {
+    uint8_t drop[8];
+    uint8_t dn = 0;
+    drop[dn++] = TRACE_DROPPED;
+    dn += put_varint(drop + dn, this->dropped_);
+    if (used + dn + 3 + frame_len <= TRACE_TX_BUFFER) {
+      this->dropped_ = 0;
+      this->push_frame_(drop, dn);
+      used = this->head_ - this->tail_;
+    }
+  }
+
+  if (used + frame_len > TRACE_TX_BUFFER || this->dropped_ > 0) {
+    // Link can't keep up: drop, and restart deltas from an absolute record
+    this->dropped_++;
+    this->dropped_total_++;
+    this->reset_encoders_();
+    return false;
+  }
+
+  const size_t mask = TRACE_TX_BUFFER - 1;
+  this->ring_[this->head_++ & mask] = TRACE_SYNC;
+  this->ring_[this->head_++ & mask] = len;
+  for (uint8_t i = 0; i < len; i++)
+    this->ring_[this->head_++ & mask] = payload[i];
+  uint8_t crc_in[TRACE_MAX_FRAME + 1];
+  crc_in[0] = len;
+  std::copy(payload, payload + len, crc_in + 1);
+  this->ring_[this->head_++ & mask] = crc8(crc_in, len + 1);
+  this->frames_++;
+  return true;
+}
+
+void TraceStream::reset_encoders_() {
+  this->raw_.absolute = true;
+  this->processed_.absolute = true;
+  this->release_absolute_ = true;
+}
+
+void TraceStream::flush(uint32_t now) {
+  if (this->uart_ == nullptr)
+    return;
+
+  // 10 bits per byte on the wire; cap at what the FIFO accepts without waiting
+  uint32_t elapsed = now - this->last_flush_;
+  this->last_flush_ = now;
+  uint32_t earned = uint32_t(uint64_t(this->uart_->get_baud_rate()) *
+                             elapsed / 10000);
+  this->budget_ = std::min(UART_FIFO_SIZE, this->budget_ + earned);
+
+  const size_t mask = TRACE_TX_BUFFER - 1;
+  while (this->budget_ > 0 && this->tail_ != this->head_) {
+    // Write the contiguous run up to the ring's end in one call
+    size_t start = this->tail_ & mask;
+    size_t avail = std::min<size_t>(this->head_ - this->tail_,
+                                    TRACE_TX_BUFFER - start);
+    size_t chunk = std::min<size_t>(avail, this->budget_);
+    this->uart_->write_array(&this->ring_[start], chunk);
+    this->tail_ += chunk;
+    this->budget_ -= chunk;
+  }
+
+  if (this->dropped_total_ != this->dropped_logged_ &&
+      now - this->last_drop_log_ > DROP_LOG_INTERVAL) {
+    ESP_LOGW("Sentio", "Trace stream: link too slow, %u records dropped",
+             this->dropped_total_ - this->dropped_logged_);
+    this->dropped_logged_ = this->dropped_total_;
+    this->last_drop_log_ = now;
+  }
+}
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_TRACE_STREAM
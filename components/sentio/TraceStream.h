@@ -0,0 +1,84 @@
+#pragma once
+#include "esphome/core/defines.h"
+
+#ifdef USE_SENTIO_TRACE_STREAM
+#include <array>
+
+#include "esphome.h"
+#include "esphome/components/uart/uart.h"
+
+namespace esphome {
+namespace sentio {
+
+// Record types on the wire. The high bit marks an absolute (key) record that
+// resets the host's delta decoder; it follows startup and every drop.
+enum TraceRecord : uint8_t {
+  TRACE_RAW = 0x01,       // Sample as read from the source
+  TRACE_PROCESSED = 0x02, // Sample after calibration (what consumers see)
+  TRACE_RELEASE = 0x03,   // Finger up
+  TRACE_DROPPED = 0x04,   // Records lost since the last one that got through
+  TRACE_LOG = 0x05,       // Tokenized log line: token, then integer args
+  TRACE_ABSOLUTE = 0x80,
+};
+
+static const uint8_t TRACE_SYNC = 0xA5;
+static const size_t TRACE_TX_BUFFER = 1024; // Power of two
+static const size_t TRACE_MAX_FRAME = 32;
+static const uint8_t TRACE_MAX_LOG_ARGS = 4;
+
+// Full-rate binary capture over a UART (or a USB-CDC port exposed as one).
+// Frame: SYNC, LEN, PAYLOAD[LEN], CRC8(LEN + PAYLOAD)
+// Records are queued into a small ring and drained at the link's baud rate,
+// never more than the hardware FIFO holds, so loop() never blocks on it.
+class TraceStream {
+public:
+  void set_uart(uart::UARTComponent *uart) { uart_ = uart; }
+
+  void record_sample(TraceRecord type, uint32_t t, uint8_t id, int16_t x,
+                     int16_t y);
+  void record_release(uint32_t t);
+  // Used through SENTIO_TLOG (TokenLog.h); extra arguments are dropped
+  template<typename... Args> void record_log(uint32_t token, Args... args) {
+    const int32_t values[] = {0, static_cast<int32_t>(args)...};
+    this->record_log_(token, values + 1, sizeof...(Args));
+  }
+  void flush(uint32_t now);
+
+  uint32_t get_frames() const { return frames_; }
+  uint32_t get_dropped() const { return dropped_total_; }
+
+protected:
+  // Delta state per record stream (raw / processed)
+  struct Encoder {
+    uint32_t t{0};
+    int16_t x{0}, y{0};
+    bool absolute{true};
+  };
+
+  void record_log_(uint32_t token, const int32_t *args, size_t count);
+  bool push_frame_(const uint8_t *payload, uint8_t len);
+  void reset_encoders_();
+
+  uart::UARTComponent *uart_{nullptr};
+
+  std::array<uint8_t, TRACE_TX_BUFFER> ring_{};
+  size_t head_{0}, tail_{0}; // Free-running, masked on access
+
+  Encoder raw_{}, processed_{};
+  uint32_t last_release_t_{0};
+  bool release_absolute_{true};
+
+  uint32_t last_flush_{0};
+  uint32_t budget_{0}; // Bytes the link can take right now
+
+  uint32_t frames_{0};
+  uint32_t dropped_{0};       // Not yet reported on the wire
+  uint32_t dropped_total_{0};
+  uint32_t dropped_logged_{0};
+  uint32_t last_drop_log_{0};
+};
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_TRACE_STREAM
@@ -0,0 +1,14 @@
+#include "VirtualClock.h"
+
+#ifdef USE_SENTIO_SOAK
+
+namespace esphome {
+namespace sentio {
+
+// Close enough to the wrap that the first minute of a soak crosses it
+uint64_t VirtualClock::offset_ms_ = UINT32_MAX - 60000u;
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_SOAK
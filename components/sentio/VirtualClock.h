@@ -0,0 +1,37 @@
+#pragma once
+#include "esphome/core/defines.h"
+
+#ifdef USE_SENTIO_SOAK
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+namespace sentio {
+
+// Soak firmware (see sentio_soak.yaml): Sentio's view of time. It starts a
+// minute short of the 32-bit millis() wrap and the soak loop skips it
+// forward through idle stretches, so months of uptime pass in minutes.
+// Everything else (source driver, logger, scheduler) keeps real time.
+class VirtualClock {
+public:
+  // Milliseconds since boot, never wrapping
+  static uint64_t now_ms() { return esphome::millis() + offset_ms_; }
+  static void advance(uint32_t ms) { offset_ms_ += ms; }
+  static uint64_t get_offset() { return offset_ms_; }
+
+protected:
+  static uint64_t offset_ms_;
+};
+
+// Unqualified millis()/micros() inside this namespace resolve here. Include
+// this header last, after anything that must stay on the real clock.
+inline uint32_t millis() { return uint32_t(VirtualClock::now_ms()); }
+inline uint32_t micros() {
+  return esphome::micros() + uint32_t(VirtualClock::get_offset() * 1000);
+}
+
+} // namespace sentio
+} // namespace esphome
+
+#endif // USE_SENTIO_SOAK
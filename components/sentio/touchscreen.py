@@ -1,33 +1,223 @@
+import json
+from pathlib import Path
+import re
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import automation
-from esphome.components import touchscreen
-from esphome.const import CONF_ID, CONF_SOURCE, CONF_OUTPUT_ID
+from esphome.components import binary_sensor, sensor, touchscreen, uart
+from esphome.core import CORE
+from esphome.helpers import write_file_if_changed
+from esphome.const import (
+    CONF_HEIGHT,
+    CONF_ID,
+    CONF_SOURCE,
+    CONF_TIMEOUT,
+    CONF_TRIGGER_ID,
+    CONF_OUTPUT_ID,
+    CONF_UART_ID,
+    CONF_WIDTH,
+    CONF_X,
+    CONF_Y,
+    DEVICE_CLASS_MOISTURE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_HERTZ,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
+    UNIT_SECOND,
+)
+
+AUTO_LOAD = ["binary_sensor", "sensor"]
 
 # Namespace - Use global namespace sentio
 # Note: external components are loaded into 'esphome.components.<name>' by the loader dynamically,
 # but we shouldn't rely on relative imports for the base class if it's confusing the loader.
 sentio_ns = cg.esphome_ns.namespace('sentio')
 SmartTouchComponent = sentio_ns.class_('SmartTouchComponent', touchscreen.Touchscreen, cg.Component)
+KeyboardRegion = sentio_ns.class_('KeyboardRegion')
+LatencyProbe = sentio_ns.class_('LatencyProbe')
+BufferPlacement = sentio_ns.enum('BufferPlacement')
+WakePolicy = sentio_ns.enum('WakePolicy')
+
+# Where large buffers go: auto puts those of 1KB and up in PSRAM when the
+# board has it, keeping internal RAM for LVGL's draw buffers
+PLACEMENTS = {
+    "auto": BufferPlacement.PLACEMENT_AUTO,
+    "internal": BufferPlacement.PLACEMENT_INTERNAL,
+    "psram": BufferPlacement.PLACEMENT_PSRAM,
+}
+
+WAKE_POLICIES = {
+    "any": WakePolicy.WAKE_ANY,
+    "double_tap": WakePolicy.WAKE_DOUBLE_TAP,
+    "hold": WakePolicy.WAKE_HOLD,
+    "swipe_up": WakePolicy.WAKE_SWIPE_UP,
+}
 
 # Configuration Constants
 CONF_DISPLAY_WIDTH = "display_width"
 CONF_DISPLAY_HEIGHT = "display_height"
 CONF_SLEEP_TIMEOUT = "sleep_timeout"
 CONF_SUPPRESS_WAKE_CLICK = "suppress_wake_click"
+CONF_ADAPTIVE_SLEEP = "adaptive_sleep"
+CONF_MIN_TIMEOUT = "min_timeout"
+CONF_MAX_TIMEOUT = "max_timeout"
+CONF_REWAKE_WINDOW = "rewake_window"
+CONF_WAKE_SENSORS = "wake_sensors"
+CONF_SUPPRESS_AFTER_PREWAKE = "suppress_touch_after_prewake"
+CONF_WAKE = "wake"
+CONF_POLICY = "policy"
+CONF_HOLD_TIME = "hold_time"
+CONF_WAKES_PREVENTED = "wakes_prevented"
+CONF_SLEEP_POLLING = "sleep_polling"
+CONF_INTERVAL = "interval"
+CONF_MAX_INTERVAL = "max_interval"
+CONF_BACKOFF_TIME = "backoff_time"
+CONF_WAKE_POLL_LATENCY = "wake_poll_latency"
+CONF_SLEEP_POLL_DUTY = "sleep_poll_duty"
 CONF_SWAP_XY = "swap_xy"
 CONF_INVERT_X = "invert_x"
 CONF_INVERT_Y = "invert_y"
 CONF_DEBOUNCE_THRESHOLD = "debounce_threshold"
+CONF_SWIPE_THRESHOLD = "swipe_threshold"
+CONF_MAX_TAP_TIME = "max_tap_time"
 CONF_DEBUG_RAW = "debug_raw_touch"
+CONF_WATER_REJECTION = "water_rejection"
+CONF_MIN_CONTACTS = "min_contacts"
+CONF_CLEAR_TIME = "clear_time"
+CONF_MIRROR_TOUCHES = "mirror_touches"
+CONF_DIRTY_PADDING = "dirty_padding"
+CONF_SHARED_CONTACTS = "shared_contacts"
+CONF_IRAM_HOT_PATH = "iram_hot_path"
+CONF_TRACE_STREAM = "trace_stream"
+CONF_STAGE_TRACE = "stage_trace"
+CONF_EVENTS = "events"
+CONF_PLACEMENT = "placement"
+CONF_BENCHMARK = "benchmark"
+CONF_ITERATIONS = "iterations"
+CONF_SOAK = "soak"
+CONF_DAYS = "days"
+CONF_MAX_IDLE = "max_idle"
+
+# Regions
+CONF_KEYBOARDS = "keyboards"
+CONF_ROWS = "rows"
+CONF_LEARN = "learn"
+CONF_ON_KEY = "on_key"
+CONF_LATENCY_PROBE = "latency_probe"
+CONF_ECHO = "echo"
+CONF_ON_PROBE = "on_probe"
+CONF_LAST = "last"
+CONF_P50 = "p50"
+CONF_P95 = "p95"
+CONF_LOST = "lost"
+
+# Diagnostics
+CONF_REPORT_RATE = "report_rate"
+CONF_REPORT_JITTER = "report_jitter"
+CONF_BOOT_TO_READY = "boot_to_ready"
+CONF_WET = "wet"
+CONF_BACKPRESSURE_EVENTS = "backpressure_events"
+CONF_BACKPRESSURE_TIME = "backpressure_time"
+CONF_TRIGGER_TIME_MAX = "trigger_time_max"
+CONF_TRIGGER_BUDGET = "trigger_budget"
+CONF_EARLY_SWIPE = "early_swipe"
+CONF_FULL_CONFIDENCE_VELOCITY = "full_confidence_velocity"
+CONF_CONFIDENCE = "confidence"
 
 # Triggers
 CONF_ON_SWIPE_LEFT = "on_swipe_left"
 CONF_ON_SWIPE_RIGHT = "on_swipe_right"
+CONF_ON_SWIPE_CANCEL = "on_swipe_cancel"
 CONF_ON_TAP = "on_tap"
 CONF_ON_WAKE = "on_wake"
 CONF_ON_SLEEP = "on_sleep"
 
+KEYBOARD_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(KeyboardRegion),
+    cv.Required(CONF_X): cv.int_range(min=0),
+    cv.Required(CONF_Y): cv.int_range(min=0),
+    cv.Required(CONF_WIDTH): cv.int_range(min=4),
+    cv.Required(CONF_HEIGHT): cv.int_range(min=4),
+    # Top to bottom; keys in a row share its width equally
+    cv.Required(CONF_ROWS): cv.All(
+        cv.ensure_list(cv.All(cv.ensure_list(cv.string), cv.Length(min=1))),
+        cv.Length(min=1),
+    ),
+    # Shift key boundaries toward where each key is actually pressed
+    cv.Optional(CONF_LEARN, default=True): cv.boolean,
+    cv.Optional(CONF_PLACEMENT, default="auto"): cv.enum(PLACEMENTS, lower=True),
+    cv.Optional(CONF_ON_KEY): automation.validate_automation(single=True),
+})
+
+
+def rtt_sensor_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+LATENCY_PROBE_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(LatencyProbe),
+    cv.Required(CONF_X): cv.int_range(min=0),
+    cv.Required(CONF_Y): cv.int_range(min=0),
+    cv.Required(CONF_WIDTH): cv.int_range(min=1),
+    cv.Required(CONF_HEIGHT): cv.int_range(min=1),
+    # Gets `seq`; send it to HA, e.g. homeassistant.event with data seq
+    cv.Required(CONF_ON_PROBE): automation.validate_automation(single=True),
+    # Entity HA sets to the received seq (a `homeassistant` sensor)
+    cv.Required(CONF_ECHO): cv.use_id(sensor.Sensor),
+    cv.Optional(CONF_TIMEOUT, default="5s"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_LAST): rtt_sensor_schema(),
+    cv.Optional(CONF_P50): rtt_sensor_schema(),
+    cv.Optional(CONF_P95): rtt_sensor_schema(),
+    cv.Optional(CONF_LOST): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+})
+
+
+def validate_adaptive_sleep(config):
+    if config[CONF_MIN_TIMEOUT] > config[CONF_MAX_TIMEOUT]:
+        raise cv.Invalid("min_timeout must not be longer than max_timeout")
+    return config
+
+
+def validate_sleep_polling(config):
+    # Both end up as whole milliseconds; 0 would turn polling off or divide by 0
+    for key in (CONF_INTERVAL, CONF_BACKOFF_TIME):
+        if config[key].total_milliseconds < 1:
+            raise cv.Invalid(f"{key} must be at least 1ms")
+    if CONF_MAX_INTERVAL in config and config[CONF_MAX_INTERVAL] < config[CONF_INTERVAL]:
+        raise cv.Invalid("max_interval must not be shorter than interval")
+    return config
+
+
+def validate_iram_hot_path(value):
+    if value and not CORE.is_esp32:
+        raise cv.Invalid("iram_hot_path is only available on ESP32")
+    return value
+
+
+def validate_keyboard_size(config):
+    keys = sum(len(row) for row in config[CONF_ROWS])
+    if keys > 64:
+        raise cv.Invalid(f"A keyboard holds at most 64 keys, got {keys}")
+    return config
+
+
+# on_tap, on_swipe_*, on_wake, on_sleep
+EVENT_AUTOMATION = automation.validate_automation({
+    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(automation.Trigger.template()),
+}, single=True)
+
 CONFIG_SCHEMA = touchscreen.TOUCHSCREEN_SCHEMA.extend({
     cv.GenerateID(): cv.declare_id(SmartTouchComponent),
     cv.Required(CONF_SOURCE): cv.use_id(touchscreen.Touchscreen),
@@ -39,22 +229,214 @@ CONFIG_SCHEMA = touchscreen.TOUCHSCREEN_SCHEMA.extend({
     # Power Management
     cv.Optional(CONF_SLEEP_TIMEOUT, default="30s"): cv.positive_time_period_milliseconds,
     cv.Optional(CONF_SUPPRESS_WAKE_CLICK, default=True): cv.boolean,
+    # Learn the timeout from idle gaps and quick re-wakes (starts at sleep_timeout)
+    cv.Optional(CONF_ADAPTIVE_SLEEP): cv.All(cv.Schema({
+        cv.Optional(CONF_MIN_TIMEOUT, default="10s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_TIMEOUT, default="5min"): cv.positive_time_period_milliseconds,
+        # A wake this soon after sleeping counts as premature sleep
+        cv.Optional(CONF_REWAKE_WINDOW, default="10s"): cv.positive_time_period_milliseconds,
+    }), validate_adaptive_sleep),
+
+    # Pre-wake: binary sensors (mmWave, PIR, proximity) that wake the panel
+    # before the finger arrives. The first touch after such a wake passes
+    # through unless suppress_touch_after_prewake is set.
+    cv.Optional(CONF_WAKE_SENSORS): cv.ensure_list(cv.use_id(binary_sensor.BinarySensor)),
+    cv.Optional(CONF_SUPPRESS_AFTER_PREWAKE, default=False): cv.boolean,
+    # What wakes the panel: any touch, or a gesture (double_tap, hold,
+    # swipe_up) so cleaning the glass or a brushing sleeve doesn't. Presence
+    # pre-wake bypasses it.
+    cv.Optional(CONF_WAKE): cv.Schema({
+        cv.Optional(CONF_POLICY, default="any"): cv.enum(WAKE_POLICIES, lower=True),
+        cv.Optional(CONF_HOLD_TIME, default="600ms"): cv.positive_time_period_milliseconds,
+    }),
+    # Panels without a touch interrupt: poll the source every `interval`
+    # while asleep instead of at its full rate, doubling it every
+    # backoff_time of sleep up to max_interval. The first contact restores
+    # full rate. Leave out for interrupt-driven sources.
+    cv.Optional(CONF_SLEEP_POLLING): cv.All(cv.Schema({
+        cv.Required(CONF_INTERVAL): cv.positive_not_null_time_period,
+        cv.Optional(CONF_MAX_INTERVAL): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_BACKOFF_TIME, default="1min"): cv.positive_not_null_time_period,
+    }), validate_sleep_polling),
 
     # Calibration
     cv.Optional(CONF_SWAP_XY, default=False): cv.boolean,
     cv.Optional(CONF_INVERT_X, default=False): cv.boolean,
     cv.Optional(CONF_INVERT_Y, default=False): cv.boolean,
     cv.Optional(CONF_DEBOUNCE_THRESHOLD, default="20ms"): cv.positive_time_period_milliseconds,
+    # Gesture thresholds (tools/sentio_tune.py fits them to recorded traces)
+    cv.Optional(CONF_SWIPE_THRESHOLD, default=30): cv.int_range(min=5, max=500),
+    cv.Optional(CONF_MAX_TAP_TIME, default="400ms"): cv.positive_time_period_milliseconds,
     cv.Optional(CONF_DEBUG_RAW, default=False): cv.boolean,
+    # Full-rate binary capture (decode with tools/sentio_trace.py).
+    # Replaces the debug_raw_touch log lines when set.
+    cv.Optional(CONF_TRACE_STREAM): cv.Schema({
+        cv.Required(CONF_UART_ID): cv.use_id(uart.UARTComponent),
+    }),
+    # Record begin/end of each pipeline stage while a finger is down.
+    # dump_stage_trace() logs the ring; tools/sentio_perfetto.py turns the
+    # log into a Chrome/Perfetto timeline. 5 bytes per event.
+    cv.Optional(CONF_STAGE_TRACE): cv.Schema({
+        cv.Optional(CONF_EVENTS, default=512): cv.int_range(min=64, max=8192),
+    }),
+    # Benchmark firmware only (see sentio_bench.yaml): replay scripted tap,
+    # swipe and multi-touch input on boot and log cycles per stage
+    cv.Optional(CONF_BENCHMARK): cv.Schema({
+        cv.Optional(CONF_ITERATIONS, default=20): cv.int_range(min=1, max=1000),
+    }),
+    # Soak firmware only (see sentio_soak.yaml): run Sentio on a virtual clock
+    # that starts just short of the millis() wrap and skips idle time, checking
+    # sleep timing, invariants, counters and heap as it goes
+    cv.Optional(CONF_SOAK): cv.Schema({
+        cv.Optional(CONF_DAYS, default=60): cv.int_range(min=1, max=3650),
+        cv.Optional(CONF_MAX_IDLE, default="2h"): cv.positive_time_period_milliseconds,
+    }),
+
+    # Outdoor panels: recognise rain/condensation (a crowd of contacts, or
+    # several that sit and drift without releasing) and ignore input until
+    # the glass has been clear for clear_time. The sleep timer keeps running.
+    cv.Optional(CONF_WATER_REJECTION): cv.Schema({
+        cv.Optional(CONF_MIN_CONTACTS, default=3): cv.int_range(min=2, max=10),
+        cv.Optional(CONF_CLEAR_TIME, default="2s"): cv.positive_time_period_milliseconds,
+    }),
+
+    # Output: keep the base `touches` container in sync (needed by LVGL).
+    # Disable when only lambdas reading `contacts()` consume Sentio.
+    cv.Optional(CONF_MIRROR_TOUCHES, default=True): cv.boolean,
+    # Margin added around each contact in take_dirty_rect() (cover your overlay size)
+    cv.Optional(CONF_DIRTY_PADDING, default=8): cv.int_range(min=0, max=255),
+    # Rendering from another task: `touches` and contacts() are only safe in
+    # loop()'s task. This adds read_contacts(), which any task may call.
+    cv.Optional(CONF_SHARED_CONTACTS, default=False): cv.boolean,
+    # Run the per-frame path (ingest, tracking, calibration, gestures) from
+    # IRAM with its state in DRAM, so it doesn't stall on flash cache misses
+    # after preference writes or OTA. Costs a few KB of IRAM; the boot log and
+    # tools/sentio_bench.py report how much.
+    cv.Optional(CONF_IRAM_HOT_PATH, default=False): cv.All(
+        cv.boolean, validate_iram_hot_path
+    ),
+
+    # Early-commit swipes: fire from the first samples' velocity instead of
+    # waiting for the 30px threshold. on_swipe_cancel fires if it was wrong.
+    cv.Optional(CONF_EARLY_SWIPE): cv.Schema({
+        # Not a minimum: the speed (px/s) at which the speed score reaches
+        # 1.0. Slower starts score proportionally less, so they need a
+        # straighter, steadier path to reach `confidence`.
+        cv.Optional(CONF_FULL_CONFIDENCE_VELOCITY, default=300): cv.positive_float,
+        cv.Optional(CONF_CONFIDENCE, default=0.8): cv.percentage,
+    }),
+
+    # On-screen keyboards (taps resolve to keys through a learned grid; key
+    # presses skip on_tap)
+    cv.Optional(CONF_KEYBOARDS): cv.ensure_list(
+        cv.All(KEYBOARD_SCHEMA, validate_keyboard_size)
+    ),
+    # Tap -> Home Assistant -> echo round trips (taps here skip on_tap)
+    cv.Optional(CONF_LATENCY_PROBE): LATENCY_PROBE_SCHEMA,
+
+    # Diagnostics
+    cv.Optional(CONF_REPORT_RATE): sensor.sensor_schema(
+        unit_of_measurement=UNIT_HERTZ,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_REPORT_JITTER): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Time from power-on until Sentio accepts input
+    cv.Optional(CONF_BOOT_TO_READY): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # On while water rejection is suppressing input
+    cv.Optional(CONF_WET): binary_sensor.binary_sensor_schema(
+        device_class=DEVICE_CLASS_MOISTURE,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Display lambdas that fell behind their own read pace, so Sentio coalesced
+    # their view (the LVGL mirror is never held back)
+    cv.Optional(CONF_BACKPRESSURE_EVENTS): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_BACKPRESSURE_TIME): sensor.sensor_schema(
+        unit_of_measurement=UNIT_SECOND,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Automations run inside Sentio's loop(): warn when one takes longer than
+    # trigger_budget, and report the slowest run seen
+    cv.Optional(CONF_TRIGGER_BUDGET, default="10ms"): cv.positive_time_period_microseconds,
+    cv.Optional(CONF_TRIGGER_TIME_MAX): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Touches while asleep that weren't the wake gesture
+    cv.Optional(CONF_WAKES_PREVENTED): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Sleep polling trade-off: the poll interval that found the last waking
+    # contact (the most it delayed that wake), and polls made while asleep
+    # as a share of full rate (bus traffic and energy spent)
+    cv.Optional(CONF_WAKE_POLL_LATENCY): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_SLEEP_POLL_DUTY): sensor.sensor_schema(
+        unit_of_measurement=UNIT_PERCENT,
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
 
     # Gestures
-    cv.Optional(CONF_ON_SWIPE_LEFT): automation.validate_automation(single=True),
-    cv.Optional(CONF_ON_SWIPE_RIGHT): automation.validate_automation(single=True),
-    cv.Optional(CONF_ON_TAP): automation.validate_automation(single=True),
-    cv.Optional(CONF_ON_WAKE): automation.validate_automation(single=True),
-    cv.Optional(CONF_ON_SLEEP): automation.validate_automation(single=True),
+    cv.Optional(CONF_ON_SWIPE_LEFT): EVENT_AUTOMATION,
+    cv.Optional(CONF_ON_SWIPE_RIGHT): EVENT_AUTOMATION,
+    # A swipe fired early turned out not to be one; undo what on_swipe_* did
+    cv.Optional(CONF_ON_SWIPE_CANCEL): EVENT_AUTOMATION,
+    cv.Optional(CONF_ON_TAP): EVENT_AUTOMATION,
+    cv.Optional(CONF_ON_WAKE): EVENT_AUTOMATION,
+    cv.Optional(CONF_ON_SLEEP): EVENT_AUTOMATION,
 }).extend(cv.COMPONENT_SCHEMA)
 
+# SENTIO_TLOG("format", ...) call sites, hashed like TokenLog.h's tokenize()
+TLOG_PATTERN = re.compile(r'SENTIO_TLOG\(\s*"((?:[^"\\]|\\.)*)"')
+TOKEN_DATABASE = "sentio_tokens.json"
+
+
+def fnv1a_32(text):
+    value = 2166136261
+    for byte in text.encode("utf-8"):
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def write_token_database():
+    tokens = {}
+    for source in sorted(Path(__file__).parent.glob("*.cpp")):
+        for literal in TLOG_PATTERN.findall(source.read_text(encoding="utf-8")):
+            fmt = literal.encode("utf-8").decode("unicode_escape")
+            token = f"{fnv1a_32(fmt):08x}"
+            if tokens.setdefault(token, fmt) != fmt:
+                raise cv.Invalid(f"Sentio log token collision: '{fmt}' and '{tokens[token]}'")
+    write_file_if_changed(
+        CORE.relative_build_path(TOKEN_DATABASE), json.dumps(tokens, indent=2, sort_keys=True)
+    )
+
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await touchscreen.register_touchscreen(var, config)
@@ -67,17 +449,130 @@ async def to_code(config):
     cg.add(var.set_resolution(config[CONF_DISPLAY_WIDTH], config[CONF_DISPLAY_HEIGHT]))
     cg.add(var.set_sleep_timeout(config[CONF_SLEEP_TIMEOUT]))
     cg.add(var.set_suppress_wake_click(config[CONF_SUPPRESS_WAKE_CLICK]))
+    if adaptive := config.get(CONF_ADAPTIVE_SLEEP):
+        cg.add(var.set_adaptive_sleep(adaptive[CONF_MIN_TIMEOUT], adaptive[CONF_MAX_TIMEOUT],
+                                      adaptive[CONF_REWAKE_WINDOW]))
+    for sensor_id in config.get(CONF_WAKE_SENSORS, []):
+        wake_sensor = await cg.get_variable(sensor_id)
+        cg.add(var.add_wake_sensor(wake_sensor))
+    cg.add(var.set_suppress_after_prewake(config[CONF_SUPPRESS_AFTER_PREWAKE]))
+    if wake := config.get(CONF_WAKE):
+        cg.add(var.set_wake_policy(wake[CONF_POLICY], wake[CONF_HOLD_TIME]))
+    if polling := config.get(CONF_SLEEP_POLLING):
+        interval = polling[CONF_INTERVAL].total_milliseconds
+        max_interval = polling.get(CONF_MAX_INTERVAL, polling[CONF_INTERVAL]).total_milliseconds
+        cg.add(var.set_sleep_polling(int(interval), int(max_interval),
+                                     int(polling[CONF_BACKOFF_TIME].total_milliseconds)))
     cg.add(var.set_calibration(config[CONF_SWAP_XY], config[CONF_INVERT_X], config[CONF_INVERT_Y]))
     cg.add(var.set_debounce_threshold(config[CONF_DEBOUNCE_THRESHOLD]))
+    cg.add(var.set_swipe_threshold(config[CONF_SWIPE_THRESHOLD]))
+    cg.add(var.set_max_tap_time(config[CONF_MAX_TAP_TIME]))
     cg.add(var.set_debug_raw(config[CONF_DEBUG_RAW]))
+    if water := config.get(CONF_WATER_REJECTION):
+        cg.add(var.set_water_rejection(water[CONF_MIN_CONTACTS], water[CONF_CLEAR_TIME]))
+    cg.add(var.set_mirror_touches(config[CONF_MIRROR_TOUCHES]))
+    cg.add(var.set_dirty_padding(config[CONF_DIRTY_PADDING]))
+    if config[CONF_SHARED_CONTACTS]:
+        cg.add_define("USE_SENTIO_SHARED_CONTACTS")
+    if config[CONF_IRAM_HOT_PATH]:
+        cg.add_define("USE_SENTIO_IRAM")
+    cg.add(var.set_trigger_budget(config[CONF_TRIGGER_BUDGET]))
+    if stream := config.get(CONF_TRACE_STREAM):
+        cg.add_define("USE_SENTIO_TRACE_STREAM")
+        write_token_database()
+        link = await cg.get_variable(stream[CONF_UART_ID])
+        cg.add(var.set_trace_stream(link))
+    if stage_trace := config.get(CONF_STAGE_TRACE):
+        cg.add_define("USE_SENTIO_STAGE_TRACE")
+        cg.add(var.set_stage_trace(stage_trace[CONF_EVENTS]))
+    if bench := config.get(CONF_BENCHMARK):
+        # Cycles are counted by the stage hooks
+        cg.add_define("USE_SENTIO_STAGE_TRACE")
+        cg.add_define("USE_SENTIO_BENCHMARK")
+        cg.add(var.set_benchmark(bench[CONF_ITERATIONS]))
+    if soak := config.get(CONF_SOAK):
+        cg.add_define("USE_SENTIO_SOAK")
+        cg.add(var.set_soak(soak[CONF_DAYS], soak[CONF_MAX_IDLE]))
+    if early := config.get(CONF_EARLY_SWIPE):
+        # px/s in YAML, px/ms in C++
+        cg.add(var.set_early_swipe(True, early[CONF_FULL_CONFIDENCE_VELOCITY] / 1000.0, early[CONF_CONFIDENCE]))
+
+    # Keyboards
+    for kb_conf in config.get(CONF_KEYBOARDS, []):
+        kb = cg.new_Pvariable(
+            kb_conf[CONF_ID],
+            str(kb_conf[CONF_ID]),
+            kb_conf[CONF_X],
+            kb_conf[CONF_Y],
+            kb_conf[CONF_WIDTH],
+            kb_conf[CONF_HEIGHT],
+        )
+        cg.add(kb.set_placement(kb_conf[CONF_PLACEMENT]))
+        for row in kb_conf[CONF_ROWS]:
+            cg.add(kb.add_row(row))
+        cg.add(kb.set_learning(kb_conf[CONF_LEARN]))
+        if CONF_ON_KEY in kb_conf:
+            await automation.build_automation(
+                kb.get_key_trigger(), [(cg.std_string, "key")], kb_conf[CONF_ON_KEY]
+            )
+        cg.add(var.add_keyboard(kb))
+
+    if probe_conf := config.get(CONF_LATENCY_PROBE):
+        probe = cg.new_Pvariable(
+            probe_conf[CONF_ID],
+            probe_conf[CONF_X],
+            probe_conf[CONF_Y],
+            probe_conf[CONF_WIDTH],
+            probe_conf[CONF_HEIGHT],
+        )
+        echo = await cg.get_variable(probe_conf[CONF_ECHO])
+        cg.add(probe.set_echo_sensor(echo))
+        cg.add(probe.set_timeout(probe_conf[CONF_TIMEOUT]))
+        await automation.build_automation(
+            probe.get_probe_trigger(), [(cg.uint32, "seq")], probe_conf[CONF_ON_PROBE]
+        )
+        for conf, setter in [
+            (CONF_LAST, probe.set_last_sensor),
+            (CONF_P50, probe.set_p50_sensor),
+            (CONF_P95, probe.set_p95_sensor),
+            (CONF_LOST, probe.set_lost_sensor),
+        ]:
+            if conf in probe_conf:
+                sens = await sensor.new_sensor(probe_conf[conf])
+                cg.add(setter(sens))
+        cg.add(var.set_latency_probe(probe))
 
-    # Register Triggers
+    # Diagnostics
+    for conf, setter in [
+        (CONF_REPORT_RATE, var.set_report_rate_sensor),
+        (CONF_REPORT_JITTER, var.set_report_jitter_sensor),
+        (CONF_BOOT_TO_READY, var.set_boot_to_ready_sensor),
+        (CONF_BACKPRESSURE_EVENTS, var.set_backpressure_events_sensor),
+        (CONF_BACKPRESSURE_TIME, var.set_backpressure_time_sensor),
+        (CONF_TRIGGER_TIME_MAX, var.set_trigger_time_max_sensor),
+        (CONF_WAKES_PREVENTED, var.set_wakes_prevented_sensor),
+        (CONF_WAKE_POLL_LATENCY, var.set_wake_poll_latency_sensor),
+        (CONF_SLEEP_POLL_DUTY, var.set_sleep_poll_duty_sensor),
+    ]:
+        if conf in config:
+            sens = await sensor.new_sensor(config[conf])
+            cg.add(setter(sens))
+
+    if CONF_WET in config:
+        wet = await binary_sensor.new_binary_sensor(config[CONF_WET])
+        cg.add(var.set_wet_sensor(wet))
+
+    # Register Triggers: a Trigger<> only for handled events; fire_() skips
+    # the rest
     for conf, trigger_fn in [
         (CONF_ON_SWIPE_LEFT, var.set_on_swipe_left),
         (CONF_ON_SWIPE_RIGHT, var.set_on_swipe_right),
+        (CONF_ON_SWIPE_CANCEL, var.set_on_swipe_cancel),
         (CONF_ON_TAP, var.set_on_tap),
         (CONF_ON_WAKE, var.set_on_wake),
         (CONF_ON_SLEEP, var.set_on_sleep),
     ]:
-        if conf in config:
-            await cv.automation.build_automation(var.get_trigger(conf), [], config[conf])
+        if automation_conf := config.get(conf):
+            trigger = cg.new_Pvariable(automation_conf[CONF_TRIGGER_ID])
+            cg.add(trigger_fn(trigger))
+            await automation.build_automation(trigger, [], automation_conf)
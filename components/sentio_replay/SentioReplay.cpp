@@ -0,0 +1,64 @@
+#include "SentioReplay.h"
+
+namespace esphome {
+namespace sentio_replay {
+
+void SentioReplay::setup() {
+  // Let the rest of the node finish booting before the first touch
+  this->start_ = millis() + this->start_delay_ms_;
+  this->pos_ = 0;
+  this->playing_ = this->len_ > 0;
+  ESP_LOGI("SentioReplay", "%u values of input, starting in %ums",
+           (unsigned) this->len_, this->start_delay_ms_);
+}
+
+void SentioReplay::restart() {
+  this->touches.clear();
+  this->start_ = millis();
+  this->pos_ = 0;
+  this->playing_ = this->len_ > 0;
+}
+
+void SentioReplay::loop() {
+  if (!this->playing_)
+    return;
+  int32_t elapsed = int32_t(millis() - this->start_);
+  if (elapsed < 0)
+    return; // Start delay
+
+  // Like a polled controller: only the newest due frame is visible
+  size_t due = SIZE_MAX;
+  while (this->pos_ < this->len_ && this->data_[this->pos_] <= elapsed) {
+    due = this->pos_;
+    this->pos_ += 2 + 3 * this->data_[this->pos_ + 1];
+  }
+  if (due != SIZE_MAX)
+    this->apply_frame_(due);
+
+  if (this->pos_ < this->len_)
+    return;
+  ESP_LOGI("SentioReplay", "Playback finished after %dms", elapsed);
+  if (this->repeat_) {
+    this->restart();
+  } else {
+    this->playing_ = false;
+  }
+  this->on_finished_.trigger();
+}
+
+void SentioReplay::apply_frame_(size_t pos) {
+  int32_t count = this->data_[pos + 1];
+  const int32_t *finger = &this->data_[pos + 2];
+
+  this->touches.clear();
+  for (int32_t i = 0; i < count; i++, finger += 3) {
+    touchscreen::TouchPoint p{};
+    p.id = finger[0];
+    p.x = finger[1];
+    p.y = finger[2];
+    this->touches[p.id] = p;
+  }
+}
+
+} // namespace sentio_replay
+} // namespace esphome
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome.h"
+#include "esphome/components/touchscreen/touchscreen.h"
+#include "esphome/core/automation.h"
+
+namespace esphome {
+namespace sentio_replay {
+
+// Touch source without hardware: plays back frames generated at build time
+// (a YAML script or a tools/sentio_trace.py capture), so Sentio configs run
+// on the host platform or on a board with no panel attached.
+//
+// Frame data, flat: t_ms, n, then id, x, y for each of n fingers. n == 0 is
+// a release. Times are relative to the start of playback.
+class SentioReplay : public touchscreen::Touchscreen {
+public:
+  void set_frames(const int32_t *data, size_t len) {
+    data_ = data;
+    len_ = len;
+  }
+  void set_start_delay(uint32_t ms) { start_delay_ms_ = ms; }
+  void set_repeat(bool b) { repeat_ = b; }
+  Trigger<> *get_finished_trigger() { return &on_finished_; }
+
+  // Play from the beginning (lambdas, or after on_finished)
+  void restart();
+  bool is_playing() const { return playing_; }
+
+  void setup() override;
+  void loop() override;
+
+protected:
+  void apply_frame_(size_t pos);
+
+  const int32_t *data_{nullptr};
+  size_t len_{0};
+  size_t pos_{0}; // Next frame not yet due
+  uint32_t start_{0};
+  uint32_t start_delay_ms_{1000};
+  bool repeat_{false};
+  bool playing_{false};
+  Trigger<> on_finished_;
+};
+
+} // namespace sentio_replay
+} // namespace esphome
@@ -0,0 +1,162 @@
+import csv
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome import automation
+from esphome.components import touchscreen
+from esphome.core import CORE
+from esphome.const import (
+    CONF_DURATION,
+    CONF_ID,
+    CONF_RAW_DATA_ID,
+    CONF_X,
+    CONF_Y,
+)
+
+sentio_replay_ns = cg.esphome_ns.namespace('sentio_replay')
+SentioReplay = sentio_replay_ns.class_('SentioReplay', touchscreen.Touchscreen)
+
+# Configuration Constants
+CONF_SCRIPT = "script"
+CONF_TRACE = "trace"
+CONF_START_DELAY = "start_delay"
+CONF_REPEAT = "repeat"
+CONF_FRAME_INTERVAL = "frame_interval"
+CONF_ON_FINISHED = "on_finished"
+
+# Script steps
+CONF_TAP = "tap"
+CONF_SWIPE = "swipe"
+CONF_TOUCH = "touch"
+CONF_WAIT = "wait"
+CONF_FINGERS = "fingers"
+CONF_TO_X = "to_x"
+CONF_TO_Y = "to_y"
+
+FINGER_SCHEMA = cv.Schema({
+    cv.Required(CONF_X): cv.int_range(min=0),
+    cv.Required(CONF_Y): cv.int_range(min=0),
+    # Straight line to here over the step's duration (default: stay put)
+    cv.Optional(CONF_TO_X): cv.int_range(min=0),
+    cv.Optional(CONF_TO_Y): cv.int_range(min=0),
+})
+
+STEP_SCHEMA = cv.Any(
+    cv.Schema({
+        cv.Required(CONF_TAP): FINGER_SCHEMA.extend({
+            cv.Optional(CONF_DURATION, default="80ms"): cv.positive_time_period_milliseconds,
+        }),
+    }),
+    cv.Schema({
+        cv.Required(CONF_SWIPE): FINGER_SCHEMA.extend({
+            cv.Optional(CONF_DURATION, default="200ms"): cv.positive_time_period_milliseconds,
+        }),
+    }),
+    # Several fingers at once (pinch, water-like crowds, ...)
+    cv.Schema({
+        cv.Required(CONF_TOUCH): cv.Schema({
+            cv.Required(CONF_FINGERS): cv.All(cv.ensure_list(FINGER_SCHEMA), cv.Length(min=1, max=10)),
+            cv.Optional(CONF_DURATION, default="300ms"): cv.positive_time_period_milliseconds,
+        }),
+    }),
+    cv.Schema({cv.Required(CONF_WAIT): cv.positive_time_period_milliseconds}),
+)
+
+CONFIG_SCHEMA = cv.All(
+    touchscreen.TOUCHSCREEN_SCHEMA.extend({
+        cv.GenerateID(): cv.declare_id(SentioReplay),
+        cv.GenerateID(CONF_RAW_DATA_ID): cv.declare_id(cg.int32),
+        # Scripted gestures, or a capture decoded by tools/sentio_trace.py
+        cv.Optional(CONF_SCRIPT): cv.ensure_list(STEP_SCHEMA),
+        cv.Optional(CONF_TRACE): cv.file_,
+        # Sample rate for scripted input (a trace keeps its own timing)
+        cv.Optional(CONF_FRAME_INTERVAL, default="16ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_START_DELAY, default="1s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_REPEAT, default=False): cv.boolean,
+        cv.Optional(CONF_ON_FINISHED): automation.validate_automation(single=True),
+    }).extend(cv.COMPONENT_SCHEMA),
+    cv.has_exactly_one_key(CONF_SCRIPT, CONF_TRACE),
+)
+
+
+def script_frames(steps, interval):
+    """Expand script steps into (t_ms, [(id, x, y), ...]) frames."""
+    frames = []
+    t = 0
+    for step in steps:
+        if CONF_WAIT in step:
+            t += step[CONF_WAIT].total_milliseconds
+            continue
+        if CONF_TOUCH in step:
+            fingers = step[CONF_TOUCH][CONF_FINGERS]
+            duration = step[CONF_TOUCH][CONF_DURATION].total_milliseconds
+        else:
+            finger = step.get(CONF_TAP) or step[CONF_SWIPE]
+            fingers = [finger]
+            duration = finger[CONF_DURATION].total_milliseconds
+
+        samples = max(1, duration // interval)
+        for k in range(samples + 1):
+            frac = k / samples
+            points = []
+            for i, f in enumerate(fingers):
+                x = f[CONF_X] + (f.get(CONF_TO_X, f[CONF_X]) - f[CONF_X]) * frac
+                y = f[CONF_Y] + (f.get(CONF_TO_Y, f[CONF_Y]) - f[CONF_Y]) * frac
+                points.append((i, round(x), round(y)))
+            frames.append((t + duration * k // samples, points))
+        # Lift, and leave one frame of nothing before the next step
+        t += duration + interval
+        frames.append((t, []))
+        t += interval
+    return frames
+
+
+def trace_frames(path):
+    """Raw samples and releases from a tools/sentio_trace.py CSV."""
+    frames = []
+    start = last = None
+    wraps = 0
+    with open(path, encoding="utf-8", newline="") as f:
+        for row in csv.DictReader(line for line in f if not line.startswith("#")):
+            if row["kind"] not in ("raw", "release"):
+                continue
+            t = int(row["t_ms"])
+            if last is not None and t < last:
+                wraps += 1  # millis() wrapped during the capture
+            last = t
+            t += wraps << 32
+            if start is None:
+                start = t
+            t -= start
+            if row["kind"] == "release":
+                frames.append((t, []))
+            elif frames and frames[-1][0] == t and frames[-1][1]:
+                frames[-1][1].append((int(row["id"]), int(row["x"]), int(row["y"])))
+            else:
+                frames.append((t, [(int(row["id"]), int(row["x"]), int(row["y"]))]))
+    if frames and frames[-1][1]:
+        frames.append((frames[-1][0] + 50, []))  # Capture ended mid-touch
+    return frames
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await touchscreen.register_touchscreen(var, config)
+
+    if CONF_SCRIPT in config:
+        frames = script_frames(config[CONF_SCRIPT], config[CONF_FRAME_INTERVAL].total_milliseconds)
+    else:
+        frames = trace_frames(CORE.relative_config_path(config[CONF_TRACE]))
+
+    data = []
+    for t, points in frames:
+        data += [t, len(points)]
+        for point in points:
+            data += point
+    prog_arr = cg.progmem_array(config[CONF_RAW_DATA_ID], data)
+    cg.add(var.set_frames(prog_arr, len(data)))
+
+    cg.add(var.set_start_delay(config[CONF_START_DELAY]))
+    cg.add(var.set_repeat(config[CONF_REPEAT]))
+    if CONF_ON_FINISHED in config:
+        await automation.build_automation(var.get_finished_trigger(), [], config[CONF_ON_FINISHED])
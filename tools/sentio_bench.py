@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Build SentIO's benchmark firmware and run it under Espressif's QEMU.
+
+Reports CPU cycles per input frame for each pipeline stage (tap, swipe and
+multi-touch workloads) plus code size, and compares them with a baseline:
+
+    python3 tools/sentio_bench.py --save-baseline bench_baseline.json
+    python3 tools/sentio_bench.py --baseline bench_baseline.json
+
+Exits with status 1 when a number grows by more than --tolerance percent.
+Needs `esphome` and Espressif's qemu-system-xtensa on PATH. QEMU runs with
+-icount so the cycle counter follows the instruction stream: counts are
+repeatable run to run, though not identical to silicon with caches and
+flash wait states.
+"""
+import argparse
+import glob
+import json
+import os
+from pathlib import Path
+import re
+import shutil
+import subprocess
+import sys
+import threading
+
+RESULT = re.compile(r"sentio-bench (\w+) frames=(\d+)((?: \w+=\d+)+)")
+DONE = "sentio-bench done"
+FLASH_SIZE = 4 * 1024 * 1024  # QEMU wants a full-size flash image
+# ESP32 internal memory, as the instruction and data buses see it
+IRAM = (0x40070000, 0x400C0000)
+DRAM = (0x3FFAE000, 0x40000000)
+
+
+def build(config):
+    subprocess.run(["esphome", "compile", config], check=True)
+    name = None
+    with open(config, encoding="utf-8") as f:
+        for line in f:
+            match = re.match(r"\s+name:\s*(\S+)", line)
+            if match:
+                name = match.group(1)
+                break
+    build_dir = Path(config).parent / ".esphome" / "build" / name / ".pioenvs" / name
+    return build_dir / "firmware.factory.bin", build_dir / "firmware.elf"
+
+
+def flash_image(factory, out):
+    data = factory.read_bytes()
+    out.write_bytes(data + b"\xff" * (FLASH_SIZE - len(data)))
+    return out
+
+
+def find_tool(name):
+    """Toolchain binary from PATH or PlatformIO's package cache."""
+    found = shutil.which(name)
+    if found:
+        return found
+    pattern = os.path.expanduser(f"~/.platformio/packages/toolchain-xtensa*/bin/{name}")
+    matches = sorted(glob.glob(pattern))
+    return matches[-1] if matches else None
+
+
+def code_size(elf):
+    """Bytes of Sentio's own code and data, plus the whole image."""
+    sizes = {}
+    nm = find_tool("xtensa-esp32-elf-nm")
+    if nm:
+        out = subprocess.run([nm, "-S", "-C", str(elf)], capture_output=True, text=True,
+                             check=True).stdout
+        total = iram = dram = 0
+        for line in out.splitlines():
+            parts = line.split(maxsplit=3)
+            if len(parts) == 4 and "sentio::" in parts[3]:
+                addr, n = int(parts[0], 16), int(parts[1], 16)
+                total += n
+                # Where iram_hot_path put it (internal RAM, not flash-mapped)
+                if IRAM[0] <= addr < IRAM[1]:
+                    iram += n
+                elif DRAM[0] <= addr < DRAM[1]:
+                    dram += n
+        sizes["sentio_bytes"] = total
+        sizes["sentio_iram_bytes"] = iram
+        sizes["sentio_dram_bytes"] = dram
+    size = find_tool("xtensa-esp32-elf-size")
+    if size:
+        out = subprocess.run([size, str(elf)], capture_output=True, text=True,
+                             check=True).stdout.splitlines()
+        text, data, bss = (int(v) for v in out[1].split()[:3])
+        sizes["flash_bytes"] = text + data
+        sizes["ram_bytes"] = data + bss
+    return sizes
+
+
+def run_qemu(qemu, image, icount, timeout):
+    cmd = [
+        qemu, "-nographic", "-machine", "esp32", "-icount", str(icount),
+        "-drive", f"file={image},if=mtd,format=raw",
+    ]
+    results = {}
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+                            errors="replace")
+    # A hung firmware prints nothing, so don't rely on reading lines to time out
+    watchdog = threading.Timer(timeout, proc.kill)
+    watchdog.start()
+    try:
+        for line in proc.stdout:
+            sys.stderr.write(line)
+            match = RESULT.search(line)
+            if match:
+                stages = dict(kv.split("=") for kv in match.group(3).split())
+                results[match.group(1)] = {k: int(v) for k, v in stages.items()}
+                results[match.group(1)]["frames"] = int(match.group(2))
+            if DONE in line:
+                break
+    finally:
+        watchdog.cancel()
+        proc.kill()
+    if not results:
+        sys.exit("benchmark produced no results (timed out?)")
+    return results
+
+
+def compare(current, baseline, tolerance):
+    """Print every metric; return the ones over tolerance."""
+    regressions = []
+    rows = [("size", k, v) for k, v in current["size"].items()]
+    for workload, stages in current["cycles"].items():
+        rows += [(workload, stage, v) for stage, v in stages.items() if stage != "frames"]
+    for group, metric, value in rows:
+        base = baseline.get("size" if group == "size" else "cycles", {})
+        base = base.get(metric) if group == "size" else base.get(group, {}).get(metric)
+        note = ""
+        if base:
+            change = 100.0 * (value - base) / base
+            note = f"{change:+.1f}%"
+            if change > tolerance:
+                note += "  REGRESSION"
+                regressions.append((group, metric))
+        print(f"{group:8} {metric:18} {value:>10}  {note}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--config", default="sentio_bench.yaml")
+    parser.add_argument("--qemu", default="qemu-system-xtensa")
+    parser.add_argument("--icount", type=int, default=3)
+    parser.add_argument("--timeout", type=float, default=180)
+    parser.add_argument("--baseline", help="fail on regressions against this file")
+    parser.add_argument("--save-baseline", help="write this run's numbers here")
+    parser.add_argument("--tolerance", type=float, default=5.0, help="percent")
+    args = parser.parse_args()
+
+    factory, elf = build(args.config)
+    image = flash_image(factory, factory.with_name("sentio_bench_flash.bin"))
+    current = {
+        "size": code_size(elf),
+        "cycles": run_qemu(args.qemu, image, args.icount, args.timeout),
+    }
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+    regressions = compare(current, baseline, args.tolerance)
+
+    if args.save_baseline:
+        with open(args.save_baseline, "w", encoding="utf-8") as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+    if regressions:
+        sys.exit(f"{len(regressions)} regression(s) over {args.tolerance}%")
+
+
+if __name__ == "__main__":
+    main()
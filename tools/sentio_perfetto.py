@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Turn a SentIO stage trace dump (stage_trace: in YAML) into Chrome JSON.
+
+Call dump_stage_trace() on the device (a template button works), capture the
+log, and convert it. Host builds print the same lines to stdout:
+
+    esphome logs node.yaml > run.log
+    python3 tools/sentio_perfetto.py run.log > trace.json
+
+Open trace.json in https://ui.perfetto.dev or chrome://tracing. Stages nest
+on the "pipeline" track; time between loop() passes shows on "loop gaps",
+where a "touch" marker starts each stretch recorded after idle time.
+Each dump line carries events of 10 hex chars: micros() (8), then the stage
+(low 7 bits) with bit 7 set on the closing event.
+"""
+import argparse
+import json
+import re
+import sys
+
+# Order of the Stage enum in StageTrace.h
+STAGE_NAMES = ["loop", "ingest", "calibrate", "filter", "recognize", "publish", "trigger"]
+STAGE_LOOP = 0
+STAGE_ARMED = 7
+END = 0x80
+
+HEADER = re.compile(r"stage-trace: (\d+) events")
+CHUNK = re.compile(r"stage-trace\[(\d+)\]: ([0-9a-f]+)")
+
+PID = 1
+TID_PIPELINE = 1
+TID_GAPS = 2
+
+
+def read_dumps(lines):
+    """Events per dump, in log order; a header line starts a new dump."""
+    dumps = []
+    for line in lines:
+        if HEADER.search(line):
+            dumps.append([])
+            continue
+        match = CHUNK.search(line)
+        if match is None or not dumps:
+            continue
+        data = match.group(2)
+        for pos in range(0, len(data) - 9, 10):
+            dumps[-1].append((int(data[pos:pos + 8], 16), int(data[pos + 8:pos + 10], 16)))
+    return dumps
+
+
+def to_chrome(events):
+    """B/E pairs for the stages, plus one complete event per loop gap."""
+    out = [
+        {"ph": "M", "pid": PID, "name": "process_name", "args": {"name": "sentio"}},
+        {"ph": "M", "pid": PID, "tid": TID_PIPELINE, "name": "thread_name", "args": {"name": "pipeline"}},
+        {"ph": "M", "pid": PID, "tid": TID_GAPS, "name": "thread_name", "args": {"name": "loop gaps"}},
+    ]
+    base = None
+    wraps = 0
+    last_raw = None
+    open_stages = []
+    last_loop_end = None
+    for raw, tag in events:
+        # micros() wraps every ~71 minutes
+        if last_raw is not None and raw < last_raw:
+            wraps += 1
+        last_raw = raw
+        t = raw + (wraps << 32)
+        if base is None:
+            base = t
+        ts = t - base
+
+        stage = tag & ~END
+        if stage == STAGE_ARMED:
+            # Idle time the device didn't record: not a loop gap
+            last_loop_end = None
+            out.append({"ph": "i", "pid": PID, "tid": TID_GAPS, "name": "touch", "ts": ts, "s": "t"})
+            continue
+        name = STAGE_NAMES[stage] if stage < len(STAGE_NAMES) else f"stage{stage}"
+        if tag & END:
+            if stage not in open_stages:
+                continue  # Began before the ring's oldest event
+            # Close anything left open inside it so the nesting stays valid
+            while open_stages:
+                inner = open_stages.pop()
+                inner_name = STAGE_NAMES[inner] if inner < len(STAGE_NAMES) else f"stage{inner}"
+                out.append({"ph": "E", "pid": PID, "tid": TID_PIPELINE, "name": inner_name, "ts": ts})
+                if inner == stage:
+                    break
+            if stage == STAGE_LOOP:
+                last_loop_end = ts
+            continue
+
+        if stage == STAGE_LOOP and last_loop_end is not None:
+            out.append({
+                "ph": "X", "pid": PID, "tid": TID_GAPS, "name": "gap",
+                "ts": last_loop_end, "dur": ts - last_loop_end,
+            })
+        open_stages.append(stage)
+        out.append({"ph": "B", "pid": PID, "tid": TID_PIPELINE, "name": name, "ts": ts})
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", help="captured log (default: stdin)")
+    parser.add_argument("--dump", type=int, default=-1,
+                        help="which dump in the log to export (default: the last)")
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, encoding="utf-8", errors="replace") as f:
+            dumps = read_dumps(f)
+    else:
+        dumps = read_dumps(sys.stdin)
+    if not dumps:
+        sys.exit("no stage-trace dump found in the log")
+
+    events = dumps[args.dump]
+    json.dump(to_chrome(events), sys.stdout)
+    print(f"# {len(events)} events from dump {args.dump % len(dumps) + 1} of {len(dumps)}",
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Decode a SentIO binary trace stream (trace_stream: in YAML) into CSV.
+
+Reads from a serial port (needs pyserial), a pty, or a captured file:
+
+    python3 tools/sentio_trace.py /dev/ttyUSB1 --baud 921600 > capture.csv
+    python3 tools/sentio_trace.py capture.bin > capture.csv
+
+Tokenized log lines (SENTIO_TLOG) are expanded with the database the build
+writes next to the firmware:
+
+    python3 tools/sentio_trace.py capture.bin \
+        --tokens .esphome/build/<node>/sentio_tokens.json
+
+Frame: 0xA5, LEN, PAYLOAD[LEN], CRC8(LEN + PAYLOAD), polynomial 0x07.
+"""
+import argparse
+import csv
+import json
+import re
+import sys
+
+SYNC = 0xA5
+RAW, PROCESSED, RELEASE, DROPPED, LOG = 0x01, 0x02, 0x03, 0x04, 0x05
+ABSOLUTE = 0x80
+NAMES = {RAW: "raw", PROCESSED: "processed", RELEASE: "release"}
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def varint(buf, pos):
+    value = shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def zigzag(buf, pos):
+    value, pos = varint(buf, pos)
+    return (value >> 1) ^ -(value & 1), pos
+
+
+def frames(stream):
+    """Yield payloads, resynchronising on the sync byte after corruption."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while len(buf) >= 3:
+            if buf[0] != SYNC:
+                del buf[0]
+                continue
+            length = buf[1]
+            if len(buf) < length + 3:
+                break
+            body = bytes(buf[1:length + 2])
+            if crc8(body) != buf[length + 2]:
+                frames.crc_errors += 1
+                del buf[0]
+                continue
+            del buf[:length + 3]
+            yield body[1:]
+
+
+frames.crc_errors = 0
+
+
+CONVERSION = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?[a-zA-Z]")
+
+
+def detokenize(fmt, args):
+    """printf-style expansion of the integer arguments the device packed."""
+    values = iter(args)
+
+    def expand(match):
+        spec = match.group(0)
+        value = next(values, 0)
+        if spec[-1] in "uxX":
+            value &= 0xFFFFFFFF
+        return (spec[:-1] + ("d" if spec[-1] == "u" else spec[-1])) % value
+
+    return CONVERSION.sub(expand, fmt.replace("%%", "\0")).replace("\0", "%")
+
+
+class Decoder:
+    def __init__(self, tokens=None):
+        self.state = {RAW: None, PROCESSED: None, RELEASE: None}
+        self.tokens = tokens or {}
+        self.dropped = 0
+
+    def decode(self, payload):
+        kind = payload[0] & ~ABSOLUTE
+        absolute = bool(payload[0] & ABSOLUTE)
+        if kind == LOG:
+            token = int.from_bytes(payload[1:5], "little")
+            args, pos = [], 5
+            while pos < len(payload):
+                value, pos = zigzag(payload, pos)
+                args.append(value)
+            fmt = self.tokens.get(f"{token:08x}")
+            if fmt is None:
+                message = f"token {token:08x} {args}"
+            else:
+                message = detokenize(fmt, args)
+            return ("log", "", "", "", message)
+        if kind == DROPPED:
+            count, _ = varint(payload, 1)
+            self.dropped += count
+            return ("dropped", "", "", "", count)
+        if kind == RELEASE:
+            t, _ = varint(payload, 1)
+            if not absolute:
+                if self.state[RELEASE] is None:
+                    return None  # Joined mid-stream; wait for a key record
+                t += self.state[RELEASE]
+            self.state[RELEASE] = t & 0xFFFFFFFF
+            return ("release", self.state[RELEASE], "", "", "")
+        if kind not in (RAW, PROCESSED):
+            return None
+        ident = payload[1]
+        t, pos = varint(payload, 2)
+        x, pos = zigzag(payload, pos)
+        y, pos = zigzag(payload, pos)
+        if not absolute:
+            prev = self.state[kind]
+            if prev is None:
+                return None
+            t, x, y = (prev[0] + t) & 0xFFFFFFFF, prev[1] + x, prev[2] + y
+        self.state[kind] = (t, x, y)
+        return (NAMES[kind], t, ident, x, y)
+
+
+def open_source(path, baud):
+    if baud:
+        import serial  # pyserial, only needed for real ports
+
+        return serial.Serial(path, baud, timeout=None)
+    return open(path, "rb", buffering=0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="serial port, pty or capture file")
+    parser.add_argument("--baud", type=int, help="open SOURCE as a serial port")
+    parser.add_argument("--tokens", help="sentio_tokens.json from the firmware build")
+    args = parser.parse_args()
+
+    tokens = None
+    if args.tokens:
+        with open(args.tokens, encoding="utf-8") as f:
+            tokens = json.load(f)
+
+    decoder = Decoder(tokens)
+    out = csv.writer(sys.stdout, lineterminator="\n")
+    out.writerow(("kind", "t_ms", "id", "x", "y"))
+    try:
+        with open_source(args.source, args.baud) as stream:
+            for payload in frames(stream):
+                row = decoder.decode(payload)
+                if row is not None:
+                    out.writerow(row)
+    except KeyboardInterrupt:
+        pass
+    print(f"# dropped={decoder.dropped} crc_errors={frames.crc_errors}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
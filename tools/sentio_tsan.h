@@ -0,0 +1,103 @@
+#pragma once
+// ThreadSanitizer stress for `shared_contacts`, built into sentio_tsan.yaml:
+// reader threads copy the contacts with read_contacts() as fast as they can
+// while loop() publishes replayed multi-touch on the main thread.
+//
+//   TSAN_OPTIONS=halt_on_error=1 SDL_VIDEODRIVER=dummy \
+//     esphome run sentio_tsan.yaml
+//
+// Exits 0 after the run with "sentio-tsan ... PASS" and the read rate, 1 on
+// a torn copy (two reads with the same publish count that differ), and
+// TSan's exit code on any data race. Building with -DSENTIO_TSAN_RACY makes
+// the readers use contacts() instead, which TSan must report.
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "esphome/components/sentio/Sentio.h"
+#include "esphome/core/log.h"
+
+namespace sentio_tsan {
+
+using esphome::sentio::Contact;
+using esphome::sentio::MAX_CONTACTS;
+using esphome::sentio::SmartTouchComponent;
+using Contacts = std::array<Contact, MAX_CONTACTS>;
+
+struct Stress {
+  std::atomic<bool> stop{false};
+  std::atomic<uint32_t> reads{0};
+  std::atomic<uint32_t> changes{0}; // Reads that saw a new publish
+  std::atomic<uint32_t> torn{0};
+  std::vector<std::thread> readers;
+  std::chrono::steady_clock::time_point start;
+};
+
+inline Stress &stress() {
+  static Stress s;
+  return s;
+}
+
+inline bool same(const Contacts &a, const Contacts &b) {
+  for (uint8_t s = 0; s < MAX_CONTACTS; s++) {
+    if (a[s].active != b[s].active)
+      return false;
+    if (!a[s].active)
+      continue;
+    const auto &p = a[s].point, &q = b[s].point;
+    if (p.id != q.id || p.x != q.x || p.y != q.y || p.pressure != q.pressure)
+      return false;
+  }
+  return true;
+}
+
+inline void reader(const SmartTouchComponent *sentio) {
+  Stress &st = stress();
+  Contacts last, copy;
+  uint32_t last_seq = sentio->read_contacts(last);
+  while (!st.stop.load(std::memory_order_relaxed)) {
+#ifdef SENTIO_TSAN_RACY
+    copy = sentio->contacts(); // Owned by loop()'s thread: a data race
+    uint32_t seq = last_seq + 1;
+#else
+    uint32_t seq = sentio->read_contacts(copy);
+#endif
+    if (seq != last_seq) {
+      last = copy;
+      last_seq = seq;
+      st.changes.fetch_add(1, std::memory_order_relaxed);
+    } else if (!same(last, copy)) {
+      st.torn.fetch_add(1, std::memory_order_relaxed);
+    }
+    st.reads.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+inline void start(const SmartTouchComponent *sentio, int readers) {
+  Stress &st = stress();
+  st.start = std::chrono::steady_clock::now();
+  for (int r = 0; r < readers; r++)
+    st.readers.emplace_back(reader, sentio);
+  ESP_LOGI("Sentio", "sentio-tsan start readers=%d", readers);
+}
+
+// Stops and joins the readers; returns the exit status
+inline int finish() {
+  Stress &st = stress();
+  st.stop = true;
+  for (auto &t : st.readers)
+    t.join();
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                              st.start)
+                    .count();
+  uint32_t torn = st.torn.load();
+  ESP_LOGI("Sentio",
+           "sentio-tsan done reads=%u (%.0f/s) changes=%u torn=%u: %s",
+           st.reads.load(), st.reads.load() / secs, st.changes.load(), torn,
+           torn == 0 ? "PASS" : "FAIL");
+  return torn == 0 ? 0 : 1;
+}
+
+} // namespace sentio_tsan
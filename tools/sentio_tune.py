@@ -0,0 +1,328 @@
+#!/usr/bin/env python3
+"""Fit SentIO's gesture thresholds to a labeled corpus of touch traces.
+
+Each corpus file is a tools/sentio_trace.py CSV with the gestures it should
+produce added as comment lines, in order (tap, swipe_left, swipe_right):
+
+    # expect: tap tap swipe_left
+    # expect: swipe_right tap
+
+Every parameter set runs the real component: the corpus is joined into one
+trace, replayed by sentio_replay into sentio on ESPHome's host platform, and
+the recognised gestures are read back from the log. Builds run in parallel,
+each worker in its own build directory so a new parameter set only
+recompiles main.cpp:
+
+    python3 tools/sentio_tune.py corpus/*.csv --jobs 8 \\
+        --grid swipe_threshold=20,30,40 --grid max_tap_time=300,400,500
+
+Prints the Pareto front of accuracy against mean decision latency (touch-down
+to the gesture firing) and the chosen parameters as a YAML snippet. Options
+the corpus panel needs (calibration, resolution) go in with --set.
+Needs `esphome` on PATH and SDL2 development headers (the host config has a
+placeholder SDL display, run headless).
+"""
+import argparse
+import concurrent.futures
+import csv
+import difflib
+import itertools
+import os
+from pathlib import Path
+import queue
+import random
+import re
+import subprocess
+import sys
+
+GESTURES = ("tap", "swipe_left", "swipe_right")
+GESTURE_LINE = re.compile(r"sentio-tune (\w+) (\d+)")
+CORPUS_GAP_MS = 1000  # Idle between joined traces
+
+# name: (YAML path under the sentio block, unit suffix)
+PARAMETERS = {
+    "swipe_threshold": ("swipe_threshold", ""),
+    "max_tap_time": ("max_tap_time", "ms"),
+    "debounce_threshold": ("debounce_threshold", "ms"),
+    "full_confidence_velocity": ("early_swipe.full_confidence_velocity", ""),
+    "early_confidence": ("early_swipe.confidence", ""),
+}
+DEFAULT_GRID = {
+    "swipe_threshold": ["20", "30", "40"],
+    "max_tap_time": ["300", "400", "500"],
+    "debounce_threshold": ["10", "20", "30"],
+}
+
+CONFIG = """\
+esphome:
+  name: {name}
+
+host:
+
+external_components:
+  - source: {components}
+
+logger:
+  level: INFO
+
+# Touchscreens need a display; nothing is drawn, so it never updates
+display:
+  - platform: sdl
+    id: tune_display
+    dimensions:
+      width: {width}
+      height: {height}
+    auto_clear_enabled: false
+    update_interval: never
+
+touchscreen:
+  - platform: sentio_replay
+    id: corpus
+    internal: true
+    start_delay: 500ms
+    trace: {trace}
+    on_finished:
+      - delay: 1s
+      - lambda: exit(0);
+
+  - platform: sentio
+    id: tuned
+    source: corpus
+    sleep_timeout: 1h
+    suppress_wake_click: false
+{sentio}
+    on_tap:
+      - lambda: ESP_LOGI("tune", "sentio-tune tap %u", id(tuned)->get_gesture_duration());
+    on_swipe_left:
+      - lambda: ESP_LOGI("tune", "sentio-tune swipe_left %u", id(tuned)->get_gesture_duration());
+    on_swipe_right:
+      - lambda: ESP_LOGI("tune", "sentio-tune swipe_right %u", id(tuned)->get_gesture_duration());
+    on_swipe_cancel:
+      - lambda: ESP_LOGI("tune", "sentio-tune swipe_cancel 0");
+"""
+
+
+def load_corpus(paths, out):
+    """Join the traces into one CSV; return the expected gestures."""
+    expected = []
+    offset = 0
+    with open(out, "w", encoding="utf-8", newline="") as f:
+        writer = csv.writer(f, lineterminator="\n")
+        writer.writerow(("kind", "t_ms", "id", "x", "y"))
+        for path in paths:
+            with open(path, encoding="utf-8", newline="") as trace:
+                lines = []
+                for line in trace:
+                    if line.startswith("# expect:"):
+                        labels = line.split(":", 1)[1].split()
+                        unknown = set(labels) - set(GESTURES)
+                        if unknown:
+                            sys.exit(f"{path}: unknown gesture(s) {', '.join(sorted(unknown))}")
+                        expected += labels
+                    elif not line.startswith("#"):
+                        lines.append(line)
+            start = last = None
+            wraps = 0
+            t = 0
+            for row in csv.DictReader(lines):
+                if row["kind"] not in ("raw", "release"):
+                    continue
+                t = int(row["t_ms"])
+                if last is not None and t < last:
+                    wraps += 1  # millis() wrapped during the capture
+                last = t
+                t += wraps << 32
+                if start is None:
+                    start = t
+                t -= start
+                writer.writerow((row["kind"], offset + t, row["id"], row["x"], row["y"]))
+            if start is not None:
+                # Always end released, then leave the panel idle a moment
+                writer.writerow(("release", offset + t + 50, "", "", ""))
+                offset += t + 50 + CORPUS_GAP_MS
+    return expected
+
+
+def sentio_block(settings):
+    """Indented YAML for the sentio options (dotted names nest)."""
+    nested = {}
+    for key, value in settings.items():
+        node = nested
+        *parents, leaf = key.split(".")
+        for parent in parents:
+            node = node.setdefault(parent, {})
+        node[leaf] = value
+
+    def emit(node, indent):
+        lines = []
+        for key, value in node.items():
+            if isinstance(value, dict):
+                lines.append(f"{' ' * indent}{key}:")
+                lines += emit(value, indent + 2)
+            else:
+                lines.append(f"{' ' * indent}{key}: {value}")
+        return lines
+
+    return "\n".join(emit(nested, 4))
+
+
+def settings_for(point, fixed):
+    settings = dict(fixed)
+    for name, value in point.items():
+        path, unit = PARAMETERS[name]
+        settings[path] = f"{value}{unit}"
+    return settings
+
+
+def find_program(workdir, name):
+    build = workdir / ".esphome" / "build" / name / ".pioenvs" / name
+    program = build / "program"
+    if not program.exists():
+        sys.exit(f"no host binary at {program}")
+    return program
+
+
+def evaluate(point, slot, args, workdir, trace, fixed):
+    """Build and run one parameter set in a worker's own build directory."""
+    name = f"sentio-tune-{slot}"
+    config = workdir / f"{name}.yaml"
+    config.write_text(CONFIG.format(
+        name=name, components=args.components, trace=trace.name,
+        width=fixed["display_width"], height=fixed["display_height"],
+        sentio=sentio_block(settings_for(point, fixed))), encoding="utf-8")
+    build = subprocess.run(["esphome", "compile", str(config)], capture_output=True, text=True,
+                           errors="replace")
+    if build.returncode != 0:
+        sys.stderr.write(build.stdout + build.stderr)
+        raise RuntimeError(f"{config.name} failed to build")
+    # Headless: the display is only there for the schema
+    env = dict(os.environ, SDL_VIDEODRIVER="dummy")
+    run = subprocess.run([str(find_program(workdir, name))], capture_output=True, text=True,
+                         errors="replace", timeout=args.timeout, env=env)
+    if run.returncode != 0:
+        sys.stderr.write(run.stdout[-2000:] + run.stderr[-2000:])
+        raise RuntimeError(f"{config.name} replay exited with {run.returncode}")
+
+    detected = []
+    for match in GESTURE_LINE.finditer(run.stdout):
+        gesture, latency = match.group(1), int(match.group(2))
+        if gesture == "swipe_cancel":
+            # A retracted early swipe never happened, as far as the user knows
+            if detected and detected[-1][0].startswith("swipe"):
+                detected.pop()
+            continue
+        detected.append((gesture, latency))
+    return detected
+
+
+def score(expected, detected):
+    """(accuracy, mean latency of correct gestures, errors)."""
+    names = [gesture for gesture, _ in detected]
+    matcher = difflib.SequenceMatcher(None, expected, names, autojunk=False)
+    correct = []
+    for block in matcher.get_matching_blocks():
+        correct += [latency for _, latency in detected[block.b:block.b + block.size]]
+    total = len(expected) + len(names)
+    accuracy = 2.0 * len(correct) / total if total else 1.0
+    latency = sum(correct) / len(correct) if correct else float("inf")
+    errors = max(len(expected), len(names)) - len(correct)
+    return accuracy, latency, errors
+
+
+def pareto(results):
+    """Points no other point beats on both accuracy and latency."""
+    front = []
+    for point, (acc, lat, err) in results:
+        dominated = any(
+            a >= acc and l <= lat and (a > acc or l < lat) for _, (a, l, _) in results)
+        if not dominated:
+            front.append((point, (acc, lat, err)))
+    return sorted(front, key=lambda r: (-r[1][0], r[1][1]))
+
+
+def parse_grid(specs):
+    grid = {}
+    for spec in specs:
+        name, _, values = spec.partition("=")
+        if name not in PARAMETERS or not values:
+            sys.exit(f"bad --grid {spec!r}; parameters: {', '.join(PARAMETERS)}")
+        grid[name] = values.split(",")
+    return grid or DEFAULT_GRID
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("corpus", nargs="+", help="labeled sentio_trace.py CSVs")
+    parser.add_argument("--grid", action="append", default=[], metavar="NAME=V1,V2,...",
+                        help=f"values to try ({', '.join(PARAMETERS)})")
+    parser.add_argument("--samples", type=int,
+                        help="evaluate this many random grid points instead of all")
+    parser.add_argument("--set", action="append", default=[], metavar="KEY=VALUE",
+                        help="fixed sentio option, e.g. display_width=320 or swap_xy=true")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count())
+    parser.add_argument("--workdir", default="sentio_tune")
+    parser.add_argument("--components", default=str(Path(__file__).resolve().parent.parent / "components"))
+    parser.add_argument("--timeout", type=float, default=600, help="seconds per replay")
+    args = parser.parse_args()
+
+    fixed = {"display_width": "320", "display_height": "240"}
+    for item in args.set:
+        key, _, value = item.partition("=")
+        fixed[key] = value
+    if any(PARAMETERS[name][0].startswith("early_swipe.") for name in parse_grid(args.grid)):
+        fixed.setdefault("early_swipe.full_confidence_velocity", "300")
+
+    workdir = Path(args.workdir).resolve()
+    workdir.mkdir(parents=True, exist_ok=True)
+    trace = workdir / "corpus.csv"
+    expected = load_corpus(args.corpus, trace)
+    if not expected:
+        sys.exit("no '# expect:' labels in the corpus")
+
+    grid = parse_grid(args.grid)
+    points = [dict(zip(grid, values)) for values in itertools.product(*grid.values())]
+    if args.samples and args.samples < len(points):
+        points = random.sample(points, args.samples)
+    print(f"{len(expected)} labeled gestures, {len(points)} parameter sets, {args.jobs} jobs",
+          file=sys.stderr)
+
+    # One build directory per worker: rebuilds stay incremental
+    slots = queue.Queue()
+    for slot in range(args.jobs):
+        slots.put(slot)
+
+    def job(point):
+        slot = slots.get()
+        try:
+            detected = evaluate(point, slot, args, workdir, trace, fixed)
+            return point, score(expected, detected), len(detected)
+        finally:
+            slots.put(slot)
+
+    results = []
+    gestures_seen = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        for point, result, count in pool.map(job, points):
+            results.append((point, result))
+            gestures_seen += count
+            print(f"  {point} -> accuracy {result[0]:.3f}, latency {result[1]:.0f}ms",
+                  file=sys.stderr)
+
+    # Silence from every build means the on_* triggers never fired, not that
+    # every parameter set missed every gesture
+    if not gestures_seen:
+        sys.exit("no parameter set produced a gesture; check that sentio's triggers fire")
+
+    front = pareto(results)
+    print("Pareto front (accuracy vs mean decision latency):")
+    for point, (acc, lat, err) in front:
+        params = " ".join(f"{k}={v}" for k, v in point.items())
+        print(f"  accuracy {acc:.3f}  latency {lat:6.0f}ms  errors {err:3}  {params}")
+
+    best, _ = front[0]
+    print("\n# Most accurate, then fastest:")
+    print(sentio_block(settings_for(best, {})))
+
+
+if __name__ == "__main__":
+    main()